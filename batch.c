@@ -0,0 +1,382 @@
+#include "batch.h"
+#include "zobrist.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The legal actions in every mode other than `NORMAL_MODE`, which don't depend on anything else. These are the same as
+ * in `parlGame_legalActions`.
+ */
+static const unsigned int PARL_BATCH_MODE_ACTIONS[16] = {
+    [DISCARD_AFTER_DRAW_MODE] = 1u << DISCARD,
+    [REIMPEACH_MODE] = 1u << REIMPEACH | 1u << NO_REIMPEACH,
+    [BLOCK_IMPEACH_MODE] = 1u << BLOCK_IMPEACH | 1u << NO_BLOCK_IMPEACH,
+    [ELECTION_MODE] = 1u << CONTEST_ELECTION | 1u << NO_CONTEST_ELECTION,
+    [BACKUP_PM_MODE] = 1u << APPOINT_BACKUP_PM,
+    [ENDGAME_MODE] = 1u << ENDGAME_TRY_FORMATION | 1u << ENDGAME_PASS_FORMATION,
+    [PM_CHOOSE_FIRST_LAST_MODE] = 1u << ENDGAME_PM_FIRST | 1u << ENDGAME_PM_LAST,
+    [BLOCK_COALITION_MODE] = 1u << ENDGAME_BLOCK_COALITION | 1u << ENDGAME_NO_BLOCK_COALITION,
+    [COUNTER_BLOCK_COALITION_MODE] = 1u << ENDGAME_COUNTER_BLOCK_COALITION | 1u << ENDGAME_NO_COUNTER_BLOCK_COALITION,
+    [GAME_OVER] = 0
+};
+
+bool parlGameBatch_init(ParlGameBatch* const b, const int capacity)
+{
+    const register size_t n = capacity;
+
+    *b = (ParlGameBatch){
+        .size = 0,
+        .capacity = capacity,
+        .parliament = malloc(n * sizeof(ParlStack)),
+        .cabinet = malloc(n * sizeof(ParlStack)),
+        .discard = malloc(n * sizeof(ParlStack)),
+        .faceDownCards = malloc(n * sizeof(ParlStack)),
+        .hands = calloc(PARL_MAX_NUM_PLAYERS * n, sizeof(ParlStack)),
+        .handSizes = calloc(PARL_MAX_NUM_PLAYERS * n, sizeof(int8_t)),
+        .turn = malloc(n),
+        .mode = malloc(n),
+        .numPlayers = malloc(n),
+        .drawDeckSize = malloc(n),
+        .pmPosition = malloc(n),
+        .pmCardIdx = malloc(n),
+        .rest = malloc(n * sizeof(ParlPerfectGame))
+    };
+
+    if(
+        b->parliament && b->cabinet && b->discard && b->faceDownCards && b->hands && b->handSizes && b->turn && b->mode
+        && b->numPlayers && b->drawDeckSize && b->pmPosition && b->pmCardIdx && b->rest
+    )
+        return true;
+
+    parlGameBatch_free(b);
+    return false;
+}
+
+void parlGameBatch_free(ParlGameBatch* const b)
+{
+    free(b->parliament);
+    free(b->cabinet);
+    free(b->discard);
+    free(b->faceDownCards);
+    free(b->hands);
+    free(b->handSizes);
+    free(b->turn);
+    free(b->mode);
+    free(b->numPlayers);
+    free(b->drawDeckSize);
+    free(b->pmPosition);
+    free(b->pmCardIdx);
+    free(b->rest);
+    memset(b, 0, sizeof *b);
+}
+
+int parlGameBatch_add(ParlGameBatch* const b, const ParlPerfectGame* const pg)
+{
+    if(b->size == b->capacity)
+        return -1;
+
+    parlGameBatch_set(b, b->size, pg);
+    return b->size++;
+}
+
+void parlGameBatch_set(ParlGameBatch* const b, const int i, const ParlPerfectGame* const pg)
+{
+    const ParlGame* const g = &pg->g;
+
+    b->parliament[i] = g->parliament;
+    b->cabinet[i] = g->cabinet;
+    b->discard[i] = g->discard;
+    b->faceDownCards[i] = g->faceDownCards;
+    b->turn[i] = g->turn;
+    b->mode[i] = g->mode;
+    b->numPlayers[i] = g->numPlayers;
+    b->drawDeckSize[i] = g->drawDeckSize;
+    b->pmPosition[i] = g->pmPosition;
+    b->pmCardIdx[i] = g->pmCardIdx;
+
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+    {
+        b->hands[p * b->capacity + i] = g->knownHands[p];
+        b->handSizes[p * b->capacity + i] = g->handSizes[p];
+    }
+
+    b->rest[i] = *pg;
+}
+
+void parlGameBatch_get(const ParlGameBatch* const b, const int i, ParlPerfectGame* const out)
+{
+    ParlGame* const g = &out->g;
+
+    *out = b->rest[i];
+
+    g->parliament = b->parliament[i];
+    g->cabinet = b->cabinet[i];
+    g->discard = b->discard[i];
+    g->faceDownCards = b->faceDownCards[i];
+    g->turn = b->turn[i];
+    g->mode = b->mode[i];
+    g->numPlayers = b->numPlayers[i];
+    g->drawDeckSize = b->drawDeckSize[i];
+    g->pmPosition = b->pmPosition[i];
+    g->pmCardIdx = b->pmCardIdx[i];
+
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+    {
+        g->knownHands[p] = b->hands[p * b->capacity + i];
+        g->handSizes[p] = b->handSizes[p * b->capacity + i];
+    }
+
+    parlGame_recountParliament(g);
+    g->hash = parlZobrist_hash(g);
+}
+
+/**
+ * @brief Same as `parlGame_tiedPluralities`, but from the suits of Parliament split up into blocks.
+ */
+static inline unsigned int parlGameBatch_tiedPluralities(const uint64_t* const parlBlocks)
+{
+    register unsigned int tiedPluralities = 0;
+    register int pluralitySuitSize = 0;
+
+    PARL_FOREACH_SUIT(s)
+    {
+        const register int thisSuitSize = PARL_POPCOUNT(parlBlocks[s]);
+
+        if(thisSuitSize > pluralitySuitSize)
+        {
+            pluralitySuitSize = thisSuitSize;
+            tiedPluralities = 1u << s;
+        }
+        else if(thisSuitSize == pluralitySuitSize)
+            tiedPluralities |= 1u << s;
+    }
+
+    return tiedPluralities;
+}
+
+/**
+ * @brief Works out the legal actions of game `i`.
+ *
+ * @details
+ * Besides the early returns for other modes and an empty hand, it branches only on the hand size and on the PM: whether
+ * there is one, and whether it's their turn with a cabinet to appoint from. With every hand known, each check in
+ * `NORMAL_MODE` comes down to a few operations on the 13-bit blocks that make up the suits of a stack:
+ * - A suit with 3 or more cards, for `CALL_ELECTION`, still has a bit left after clearing the lowest one twice.
+ * - A rank with 3 or more cards, for `VOTE_NO_CONF`, is set in at least 3 of the 4 blocks.
+ * - An MP "at or above" a rank in some suit is a bit at or below the highest bit of that suit's block, so smearing the
+ *   highest bit down gives every rank that doesn't beat that suit's MPs.
+ * - A card that outranks some MP, for `IMPEACH_MP`, is any rank in the hand above the lowest rank in Parliament.
+ */
+static unsigned int parlGameBatch_legalActionsOf(const ParlGameBatch* const b, const int i)
+{
+    if(b->mode[i] != NORMAL_MODE)
+        return PARL_BATCH_MODE_ACTIONS[b->mode[i]];
+
+    const register int k = b->turn[i] * b->capacity + i;
+    const register ParlStack hand = b->hands[k], parliament = b->parliament[i];
+    const register int handSize = b->handSizes[k];
+    const register int parlSize = PARL_STACK_SIZE(parliament);
+    const register bool hasPm = b->pmPosition[i] != PARL_NO_PM;
+    register unsigned int legal = 0;
+
+    if(b->turn[i] == b->pmPosition[i] && b->cabinet[i])
+        legal |= 1u << APPOINT_PM | (PARL_WITHOUT_JOKERS(parliament) ? 1u << CABINET_RESHUFFLE : 0);
+
+    if(handSize <= PARL_MAX_CARDS_IN_HAND)
+        legal |= 1u << DRAW;
+
+    if(!handSize)
+        return legal;
+
+    legal |= 1u << DISCARD;
+
+    if(parlSize < 2 * b->numPlayers[i])
+        legal |= 1u << APPOINT_MP;
+
+    register uint64_t handRanks = 0, parlRanks = 0;
+    uint64_t handBlocks[PARL_NUM_SUITS], parlBlocks[PARL_NUM_SUITS];
+
+    PARL_FOREACH_SUIT(s)
+    {
+        handBlocks[s] = PARL_SUIT_RANKS(hand, s);
+        parlBlocks[s] = PARL_SUIT_RANKS(parliament, s);
+        handRanks |= handBlocks[s];
+        parlRanks |= parlBlocks[s];
+    }
+
+    if(handSize >= 3)
+    {
+        register uint64_t electionSuits = 0;
+
+        PARL_FOREACH_SUIT(s)
+        {
+            const register uint64_t withoutLowest = handBlocks[s] & (handBlocks[s] - 1);
+            electionSuits |= withoutLowest & (withoutLowest - 1);
+        }
+
+        if(electionSuits)
+            legal |= 1u << CALL_ELECTION;
+
+        const register uint64_t h0 = handBlocks[0], h1 = handBlocks[1], h2 = handBlocks[2], h3 = handBlocks[3],
+            tripleRanks = (h0 & h1 & (h2 | h3)) | (h2 & h3 & (h0 | h1));
+
+        if(hasPm && tripleRanks)
+        {
+            const register unsigned int pluralities = parlGameBatch_tiedPluralities(parlBlocks);
+            register uint64_t canVote = 0;
+
+            PARL_FOREACH_SUIT(s)
+                if(pluralities & 1u << s)
+                    canVote |= handBlocks[s] & ~parlRanksUpToHighest(parlBlocks[s]);
+
+            if(canVote & tripleRanks)
+                legal |= 1u << VOTE_NO_CONF;
+        }
+    }
+
+    if(hasPm)
+    {
+        const register ParlRank pmRank = PARL_RANK(b->pmCardIdx[i]);
+        const register uint64_t beatsPm = pmRank == PARL_KING_RANK
+            ? 1ull << PARL_KING_RANK
+            : PARL_RANKS_ABOVE(pmRank);
+
+        if(handRanks & beatsPm)
+            legal |= 1u << IMPEACH_PM;
+    }
+
+    if((handRanks & -((parlRanks & -parlRanks) << 1)) || (PARL_NUM_JOKERS(hand) && parlRanks))
+        legal |= 1u << IMPEACH_MP;
+
+    return legal;
+}
+
+void parlGameBatch_legalActions(const ParlGameBatch* const b, unsigned int* const out)
+{
+    for(register int i = 0; i < b->size; ++i)
+        out[i] = parlGameBatch_legalActionsOf(b, i);
+}
+
+/**
+ * @brief Applies an action to game `i` through perfect.h, for when it leaves the paths handled on the arrays.
+ * @return Whether the action was legal.
+ */
+static bool parlGameBatch_applyOne(ParlGameBatch* const b, const int i, const ParlAction a, const ParlIdx card)
+{
+    ParlPerfectGame pg;
+
+    parlGameBatch_get(b, i, &pg);
+    if(!parlPerfect_applyAction(&pg, a, card, PARL_NO_ARG, PARL_NO_ARG))
+        return false;
+
+    parlGameBatch_set(b, i, &pg);
+    return true;
+}
+
+/**
+ * @brief Takes `card` out of the hand of the player whose turn it is in game `i`.
+ * @return Whether they had it.
+ */
+static inline bool parlGameBatch_removeFromHand(ParlGameBatch* const b, const int i, const ParlStack card)
+{
+    const register int k = b->turn[i] * b->capacity + i;
+
+    if(!PARL_CONTAINS(b->hands[k], card))
+        return false;
+
+    b->hands[k] -= card;
+    b->handSizes[k] -= PARL_STACK_SIZE(card);
+    return true;
+}
+
+static inline void parlGameBatch_incTurn(ParlGameBatch* const b, const int i)
+{
+    b->turn[i] = b->turn[i] >= b->numPlayers[i] - 1 ? 0 : b->turn[i] + 1;
+}
+
+void parlGameBatch_draw(ParlGameBatch* const b, const uint8_t* const lanes, bool* const ok)
+{
+    for(register int i = 0; i < b->size; ++i)
+    {
+        if(!lanes[i])
+            continue;
+
+        const register int deckSize = b->drawDeckSize[i];
+        const register int k = b->turn[i] * b->capacity + i;
+        register bool success = deckSize > 0;
+
+        // Drawing the last card without going over the hand limit starts the endgame
+        if(deckSize == 1 && b->handSizes[k] < PARL_MAX_CARDS_IN_HAND)
+            success = parlGameBatch_applyOne(b, i, DRAW, PARL_NO_ARG);
+        else if(success)
+        {
+            const register ParlStack card = PARL_CARD(b->rest[i].drawDeck[deckSize - 1]);
+
+            b->hands[k] += card;
+            b->faceDownCards[i] -= card;
+            --b->drawDeckSize[i];
+
+            if(++b->handSizes[k] > PARL_MAX_CARDS_IN_HAND)
+                b->mode[i] = DISCARD_AFTER_DRAW_MODE;
+            else
+                parlGameBatch_incTurn(b, i);
+        }
+
+        if(ok)
+            ok[i] = success;
+    }
+}
+
+void parlGameBatch_discard(ParlGameBatch* const b, const uint8_t* const lanes, const ParlIdx* const cards, bool* const ok)
+{
+    for(register int i = 0; i < b->size; ++i)
+    {
+        if(!lanes[i])
+            continue;
+
+        // Any of the player's jokers will do
+        const register ParlStack hand = b->hands[b->turn[i] * b->capacity + i],
+            card = PARL_ARG_CARD(parlMatchJoker(cards[i], hand));
+        register bool success;
+
+        // Discarding after drawing the last card starts the endgame, and other modes are rare enough not to bother with
+        if(b->mode[i] == DISCARD_AFTER_DRAW_MODE ? !b->drawDeckSize[i] : b->mode[i] != NORMAL_MODE)
+            success = parlGameBatch_applyOne(b, i, DISCARD, cards[i]);
+        else if((success = parlGameBatch_removeFromHand(b, i, card)))
+        {
+            b->discard[i] += card;
+
+            if(b->mode[i] == DISCARD_AFTER_DRAW_MODE)
+                b->mode[i] = NORMAL_MODE;
+
+            parlGameBatch_incTurn(b, i);
+        }
+
+        if(ok)
+            ok[i] = success;
+    }
+}
+
+void parlGameBatch_appointMp(ParlGameBatch* const b, const uint8_t* const lanes, const ParlIdx* const cards, bool* const ok)
+{
+    for(register int i = 0; i < b->size; ++i)
+    {
+        if(!lanes[i])
+            continue;
+
+        // Any of the player's jokers will do
+        const register ParlStack hand = b->hands[b->turn[i] * b->capacity + i],
+            card = PARL_ARG_CARD(parlMatchJoker(cards[i], hand));
+        const register bool success = parlGameBatch_removeFromHand(b, i, card);
+
+        if(success)
+        {
+            b->parliament[i] += card;
+            parlGameBatch_incTurn(b, i);
+        }
+
+        if(ok)
+            ok[i] = success;
+    }
+}
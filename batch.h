@@ -0,0 +1,142 @@
+/**
+ * @file
+ * @brief Many full-information games stored as parallel arrays so that they can be stepped together.
+ *
+ * @details
+ * Playing out millions of random games one `ParlGame` at a time spends most of its time chasing pointers and branching
+ * on one game's state. A `ParlGameBatch` instead keeps each field that the common actions touch in its own array,
+ * indexed by game, so that the same step can be taken for many games at once.
+ *
+ * The layout is the point, not SIMD: every loop here is plain scalar code, one game at a time, that walks the arrays in
+ * order. `parlGameBatch_legalActions` works out the legal actions of each game with bitboard arithmetic on its hand
+ * and Parliament, branching only on the mode, the hand size, and the PM.
+ * `parlGameBatch_draw`, `parlGameBatch_discard`, and `parlGameBatch_appointMp` apply the most common actions to chosen
+ * games directly on the arrays. Any game that would leave the common path, such as
+ * by drawing the last card and going into the endgame, is taken out, stepped with perfect.h, and put back. Every other
+ * action can be applied the same way with `parlGameBatch_get` and `parlGameBatch_set`.
+ *
+ * The actions aren't vectorized because each game reads and writes the hand of whichever player's turn it is, which
+ * would need a gather and a scatter per field, and the common path is only a handful of operations once the hand is
+ * loaded. A vectorized `parlGameBatch_legalActions` was tried and was about twice as slow as the scalar loop.
+ *
+ * Only full-information games (see perfect.h) can be batched, and the batch doesn't keep `ParlGame.hash` up to date.
+ * It's worked out again by `parlGameBatch_get`.
+ */
+
+#ifndef PARLIAMENT_BATCH_H
+#define PARLIAMENT_BATCH_H
+
+#include "game.h"
+#include "perfect.h"
+
+typedef struct ParlGameBatch
+{
+    /**
+     * The number of games in the batch, and the most it can hold.
+     */
+    int size, capacity;
+
+    /* The fields of each game that the common actions touch, indexed by game */
+
+    ParlStack* parliament;
+    ParlStack* cabinet;
+    ParlStack* discard;
+    ParlStack* faceDownCards;
+
+    /**
+     * Player `p`'s hand in game `i` is `hands[p * capacity + i]`.
+     */
+    ParlStack* hands;
+
+    /**
+     * Player `p`'s hand size in game `i` is `handSizes[p * capacity + i]`.
+     */
+    int8_t* handSizes;
+
+    uint8_t* turn;
+    uint8_t* mode;
+    uint8_t* numPlayers;
+    uint8_t* drawDeckSize;
+    int8_t* pmPosition;
+    uint8_t* pmCardIdx;
+
+    /**
+     * Everything else about each game, including the order of its draw deck. The fields that have their own array
+     * above are out of date here.
+     */
+    ParlPerfectGame* rest;
+} ParlGameBatch;
+
+/**
+ * @brief Allocates room for games in `b` and empties it.
+ * @param b
+ * @param capacity The most games `b` can hold.
+ * @return Whether the initialization was successful.
+ */
+bool parlGameBatch_init(ParlGameBatch* b, int capacity);
+
+/**
+ * @brief Frees the memory allocated for `b`, not including the `ParlGameBatch` struct itself.
+ * @param b
+ */
+void parlGameBatch_free(ParlGameBatch* b);
+
+/**
+ * @brief Adds a game to the end of `b`.
+ * @param b
+ * @param pg
+ * @return The index of the game in `b`, or -1 if `b` is full.
+ */
+int parlGameBatch_add(ParlGameBatch* b, const ParlPerfectGame* pg);
+
+/**
+ * @brief Replaces game `i` of `b` with `pg`.
+ * @param b
+ * @param i Must be less than `b->size`.
+ * @param pg
+ */
+void parlGameBatch_set(ParlGameBatch* b, int i, const ParlPerfectGame* pg);
+
+/**
+ * @brief Copies game `i` of `b` into `out`.
+ * @param b
+ * @param i Must be less than `b->size`.
+ * @param out
+ */
+void parlGameBatch_get(const ParlGameBatch* b, int i, ParlPerfectGame* out);
+
+/**
+ * @brief Same as `parlGame_legalActions` for every game in `b`.
+ * @param b
+ * @param out Where to write the legal actions of each game. This must have room for `b->size` of them.
+ */
+void parlGameBatch_legalActions(const ParlGameBatch* b, unsigned int* out);
+
+/**
+ * @brief Same as `parlPerfect_applyAction` with `DRAW` for the chosen games in `b`.
+ * @param b
+ * @param lanes Which games to apply the action to. It has one entry per game, and nonzero means the game is chosen.
+ * @param ok Where to write whether the action was legal for each chosen game, or `NULL`. Entries for games that
+ * weren't chosen are left alone.
+ */
+void parlGameBatch_draw(ParlGameBatch* b, const uint8_t* lanes, bool* ok);
+
+/**
+ * @brief Same as `parlPerfect_applyAction` with `DISCARD` for the chosen games in `b`.
+ * @param b
+ * @param lanes See `parlGameBatch_draw`.
+ * @param cards The card to discard in each game. Entries for games that weren't chosen are ignored.
+ * @param ok See `parlGameBatch_draw`.
+ */
+void parlGameBatch_discard(ParlGameBatch* b, const uint8_t* lanes, const ParlIdx* cards, bool* ok);
+
+/**
+ * @brief Same as `parlPerfect_applyAction` with `APPOINT_MP` for the chosen games in `b`.
+ * @param b
+ * @param lanes See `parlGameBatch_draw`.
+ * @param cards The card to appoint in each game. Entries for games that weren't chosen are ignored.
+ * @param ok See `parlGameBatch_draw`.
+ */
+void parlGameBatch_appointMp(ParlGameBatch* b, const uint8_t* lanes, const ParlIdx* cards, bool* ok);
+
+#endif //PARLIAMENT_BATCH_H
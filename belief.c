@@ -0,0 +1,112 @@
+#include "belief.h"
+
+/**
+ * @param suit
+ * @param r
+ * @return The cards of the suit `suit` ranked above `r`.
+ */
+#define PARL_BELIEF_SUIT_ABOVE(suit, r) (PARL_RANKS_ABOVE(r) << (suit) * PARL_NUM_RANKS)
+
+/**
+ * @brief Multiplies the weights of the non-joker cards in `cards` for the player `p` by `factor`, in fixed point.
+ */
+static void parlBelief_scale(ParlBelief* const b, const ParlPlayer p, const ParlStack cards, const unsigned int factor)
+{
+    PARL_FOREACH_IN_STACK(cards, i)
+    {
+        const register unsigned int scaled = b->weights[p][i] * factor / PARL_BELIEF_ONE;
+        b->weights[p][i] = scaled ? scaled : 1;
+    }
+}
+
+void parlBelief_init(ParlBelief* const b)
+{
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+        for(register int i = 0; i < PARL_BELIEF_NUM_COLUMNS; ++i)
+            b->weights[p][i] = PARL_BELIEF_ONE;
+}
+
+void parlBelief_update(ParlBelief* const b, const ParlGame* const before, const ParlMove m, const ParlGame* const after)
+{
+    const register ParlPlayer p = before->turn;
+
+    /* Step 1: Start over on cards that were turned face up or went back into the draw deck */
+
+    const register ParlStack changed = PARL_WITHOUT_JOKERS(before->faceDownCards ^ after->faceDownCards);
+
+    if(changed)
+        PARL_FOREACH_PLAYER(before, q)
+            PARL_FOREACH_IN_STACK(changed, i)
+                b->weights[q][i] = PARL_BELIEF_ONE;
+
+    // There's nothing to guess about a hand that's known
+    if(PARL_KNOWS_HAND(before, p))
+        return;
+
+    /* Step 2: Work out what the move says about the rest of the hand of the player who made it */
+
+    switch(m.action)
+    {
+        case DRAW:;
+            // The hand now has one more card that's as likely to be anything as not
+            const register int handSize = after->handSizes[p];
+
+            for(register int i = 0; i < PARL_BELIEF_NUM_COLUMNS; ++i)
+                b->weights[p][i] += (PARL_BELIEF_ONE - b->weights[p][i]) / handSize;
+            break;
+
+        case NO_BLOCK_IMPEACH:
+        case NO_REIMPEACH:;
+            const register ParlSuit suit = PARL_SUIT(before->impeachedMpIdx);
+            register ParlStack blockers = PARL_BELIEF_SUIT_ABOVE(suit, PARL_RANK(before->cardToBeatIdx));
+
+            // An ace of the impeached MP's suit blocks a joker
+            if(PARL_IS_JOKER(before->cardToBeatIdx))
+                blockers |= PARL_CARD(PARL_RS_TO_IDX(PARL_ACE_RANK, suit));
+
+            parlBelief_scale(b, p, blockers, PARL_BELIEF_PASS_WEIGHT);
+            break;
+
+        case ENDGAME_NO_BLOCK_COALITION:
+        case ENDGAME_NO_COUNTER_BLOCK_COALITION:
+            if(!PARL_IS_JOKER(before->cardToBeatIdx))
+                parlBelief_scale(
+                    b,
+                    p,
+                    PARL_BELIEF_SUIT_ABOVE(PARL_SUIT(before->cardToBeatIdx), PARL_RANK(before->cardToBeatIdx)),
+                    PARL_BELIEF_PASS_WEIGHT
+                );
+            break;
+
+        case CALL_ELECTION:
+        case CONTEST_ELECTION:
+            // A higher card of the PM candidate's suit would have been a stronger candidate
+            if(!PARL_IS_JOKER(m.idxA))
+                parlBelief_scale(
+                    b,
+                    p,
+                    PARL_BELIEF_SUIT_ABOVE(PARL_SUIT(m.idxA), PARL_RANK(m.idxA)),
+                    PARL_BELIEF_PASS_WEIGHT
+                );
+            break;
+
+        case NO_CONTEST_ELECTION:;
+            // Any card ranked above the strongest candidate so far could have won, given a calling card of its suit
+            register ParlRank strongest = PARL_ACE_RANK;
+            register ParlStack winners = PARL_EMPTY_STACK;
+
+            PARL_FOREACH_PLAYER(before, q)
+                if(before->elecCands[q].callingCards != PARL_EMPTY_STACK
+                    && PARL_RANK(before->elecCands[q].pmIdx) > strongest)
+                    strongest = PARL_RANK(before->elecCands[q].pmIdx);
+
+            PARL_FOREACH_SUIT(s)
+                winners |= PARL_BELIEF_SUIT_ABOVE(s, strongest);
+
+            parlBelief_scale(b, p, winners, PARL_BELIEF_WEAK_PASS_WEIGHT);
+            break;
+
+        default:
+            break;
+    }
+}
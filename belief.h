@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @brief How likely each player is to hold each face-down card, judging by the moves they've made.
+ *
+ * @details
+ * A `ParlGame` only records the cards the known player is certain about. A `ParlBelief` adds a weight for every player
+ * and card, relative to `PARL_BELIEF_ONE`, which means nothing is known either way. `parlBelief_update` adjusts the
+ * weights after each move with a few rules of thumb:
+ * - A player who passes up a chance to block an impeachment or coalition probably has no card that could have blocked
+ *   it, so those cards become less likely.
+ * - A player who runs in an election with a PM candidate probably has no higher card of its suit, since that would have
+ *   been a stronger candidate. One who doesn't run at all probably has few cards that could have won.
+ * - A player who draws an unseen card holds one more random card, so everything guessed about their hand counts for
+ *   less and their weights move back towards `PARL_BELIEF_ONE`.
+ * - A card that's turned face up, or that goes back into the draw deck, starts over at `PARL_BELIEF_ONE`.
+ *
+ * `parlWorld_sampleBelief` deals determinizations that follow the weights, so that a search spends its samples on the
+ * worlds that the moves so far make likely.
+ */
+
+#ifndef PARLIAMENT_BELIEF_H
+#define PARLIAMENT_BELIEF_H
+
+#include "game.h"
+
+/**
+ * The weight of a card that's neither more nor less likely than any other.
+ */
+#define PARL_BELIEF_ONE 4096
+
+/**
+ * One column per non-joker card, plus one that all jokers share since they're interchangeable.
+ */
+#define PARL_BELIEF_NUM_COLUMNS (PARL_JOKER_IDX + 1)
+
+/**
+ * @param i
+ * @return The column of `weights` for the card `i`.
+ */
+#define PARL_BELIEF_COLUMN(i) (PARL_IS_JOKER(i) ? PARL_JOKER_IDX : (i))
+
+/**
+ * What a card's weight is multiplied by when a player passes up a move that it would have let them make.
+ */
+#define PARL_BELIEF_PASS_WEIGHT (PARL_BELIEF_ONE / 4)
+
+/**
+ * What a card's weight is multiplied by when a player passes up a move that it might have let them make.
+ */
+#define PARL_BELIEF_WEAK_PASS_WEIGHT (PARL_BELIEF_ONE / 2)
+
+typedef struct ParlBelief
+{
+    /**
+     * `weights[p][PARL_BELIEF_COLUMN(i)]` is how likely player `p` is to hold the card `i` in fixed point, where
+     * `PARL_BELIEF_ONE` is neutral. Weights stay between 1 and `PARL_BELIEF_ONE`, so a card is never ruled out.
+     */
+    uint16_t weights[PARL_MAX_NUM_PLAYERS][PARL_BELIEF_NUM_COLUMNS];
+} ParlBelief;
+
+/**
+ * @brief Sets every weight to `PARL_BELIEF_ONE`, for the start of a game.
+ * @param b
+ */
+void parlBelief_init(ParlBelief* b);
+
+/**
+ * @brief Adjusts the weights for the move `m` from `before` to `after`.
+ * @param b
+ * @param before The game right before `m`.
+ * @param m
+ * @param after The game right after `m`, as left by `parlGame_applyAction`.
+ */
+void parlBelief_update(ParlBelief* b, const ParlGame* before, ParlMove m, const ParlGame* after);
+
+#endif //PARLIAMENT_BELIEF_H
@@ -0,0 +1,507 @@
+/**
+ * @file
+ * @brief Micro-benchmarks for the hot functions in cards.c and game.c.
+ *
+ * @details
+ * Usage: `parliament_bench [--json] [--samples N] [--seed N] [--filter TEXT]`
+ *
+ * Every benchmark runs one function over a fixed set of inputs. The game states are taken from random games played from
+ * the known player's point of view, so they're realistic but the same for the same seed. Each benchmark first doubles
+ * its repetitions until one sample takes at least `PARL_BENCH_MIN_SAMPLE_NS`, which also warms it up, and then takes
+ * `--samples` samples. The time per call is reported as percentiles over the samples, in CSV by default or in JSON with
+ * `--json`.
+ *
+ * `parlGame_applyAction` has to be timed on a fresh copy of the state every call, so its times include a
+ * `parlGame_deepCopy`, which is benchmarked on its own for comparison.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "game.h"
+#include "rng.h"
+#include "timer.h"
+
+#define PARL_BENCH_NUM_MODES (GAME_OVER + 1)
+#define PARL_BENCH_NUM_ACTIONS (ENDGAME_NO_COUNTER_BLOCK_COALITION + 1)
+
+/**
+ * The most inputs collected for each mode or action, and the number of random stacks.
+ */
+#define PARL_BENCH_BIN_SIZE 256
+
+/**
+ * The most random games played to collect states.
+ */
+#define PARL_BENCH_MAX_GAMES 2000
+
+/**
+ * The most moves played in one random game.
+ */
+#define PARL_BENCH_MAX_PLIES 1000
+
+#define PARL_BENCH_MIN_SAMPLE_NS 1000000
+
+static const char* const PARL_BENCH_MODE_NAMES[PARL_BENCH_NUM_MODES] = {
+    "NORMAL_MODE",
+    "DISCARD_AFTER_DRAW_MODE",
+    "REIMPEACH_MODE",
+    "BLOCK_IMPEACH_MODE",
+    "ELECTION_MODE",
+    "BACKUP_PM_MODE",
+    "ENDGAME_MODE",
+    "PM_CHOOSE_FIRST_LAST_MODE",
+    "BLOCK_COALITION_MODE",
+    "COUNTER_BLOCK_COALITION_MODE",
+    "GAME_OVER"
+};
+
+static const char* const PARL_BENCH_ACTION_NAMES[PARL_BENCH_NUM_ACTIONS] = {
+    "DRAW",
+    "SELF_DRAW",
+    "DISCARD",
+    "APPOINT_MP",
+    "CALL_ELECTION",
+    "IMPEACH_MP",
+    "IMPEACH_PM",
+    "VOTE_NO_CONF",
+    "CABINET_RESHUFFLE",
+    "APPOINT_PM",
+    "REIMPEACH",
+    "BLOCK_IMPEACH",
+    "NO_REIMPEACH",
+    "NO_BLOCK_IMPEACH",
+    "CONTEST_ELECTION",
+    "NO_CONTEST_ELECTION",
+    "APPOINT_BACKUP_PM",
+    "ENDGAME_PM_FIRST",
+    "ENDGAME_PM_LAST",
+    "ENDGAME_TRY_FORMATION",
+    "ENDGAME_PASS_FORMATION",
+    "ENDGAME_BLOCK_COALITION",
+    "ENDGAME_COUNTER_BLOCK_COALITION",
+    "ENDGAME_NO_BLOCK_COALITION",
+    "ENDGAME_NO_COUNTER_BLOCK_COALITION"
+};
+
+/**
+ * @brief Game states and moves to benchmark with, sorted by mode and action.
+ */
+typedef struct ParlBenchCorpus
+{
+    ParlGame byMode[PARL_BENCH_NUM_MODES][PARL_BENCH_BIN_SIZE];
+    int numByMode[PARL_BENCH_NUM_MODES];
+
+    /**
+     * A state from `byAction` together with the move in `actionMoves` that's played from it.
+     */
+    ParlGame byAction[PARL_BENCH_NUM_ACTIONS][PARL_BENCH_BIN_SIZE];
+    ParlMove actionMoves[PARL_BENCH_NUM_ACTIONS][PARL_BENCH_BIN_SIZE];
+    int numByAction[PARL_BENCH_NUM_ACTIONS];
+
+    /**
+     * Every state in `byMode`, one after another.
+     */
+    ParlGame all[PARL_BENCH_NUM_MODES * PARL_BENCH_BIN_SIZE];
+
+    /**
+     * For each state in `all`, a few cards that the player whose turn it is might hold, and sometimes one they can't.
+     */
+    ParlStack allSubsets[PARL_BENCH_NUM_MODES * PARL_BENCH_BIN_SIZE];
+    int numAll;
+
+    /**
+     * Random stacks, in pairs for `parlRemoveCardsPartial`.
+     */
+    ParlStack stacks[2 * PARL_BENCH_BIN_SIZE];
+} ParlBenchCorpus;
+
+typedef struct ParlBenchCase ParlBenchCase;
+
+/**
+ * @brief Runs a benchmarked function `reps` times on every input of `c`.
+ * @return Something computed from the results, so that the calls can't be optimized away.
+ */
+typedef uint64_t (*ParlBenchFn)(const ParlBenchCase* c, long reps);
+
+struct ParlBenchCase
+{
+    char name[64];
+    ParlBenchFn fn;
+    const ParlGame* games;
+    const ParlStack* stacks;
+    const ParlMove* moves;
+
+    /**
+     * The number of calls to the benchmarked function per repetition.
+     */
+    int n;
+};
+
+static volatile uint64_t parlBench_sink;
+
+static uint64_t parlBench_stackSize(const ParlBenchCase* const c, const long reps)
+{
+    register uint64_t sum = 0;
+
+    for(register long r = 0; r < reps; ++r)
+        for(register int i = 0; i < c->n; ++i)
+            sum += parlStackSize(c->stacks[i]);
+
+    return sum;
+}
+
+static uint64_t parlBench_removeCardsPartial(const ParlBenchCase* const c, const long reps)
+{
+    register uint64_t sum = 0;
+
+    for(register long r = 0; r < reps; ++r)
+        for(register int i = 0; i < c->n; ++i)
+        {
+            ParlStack s = c->stacks[2 * i];
+            parlRemoveCardsPartial(&s, c->stacks[2 * i + 1]);
+            sum += s;
+        }
+
+    return sum;
+}
+
+static uint64_t parlBench_handContains(const ParlBenchCase* const c, const long reps)
+{
+    register uint64_t sum = 0;
+
+    for(register long r = 0; r < reps; ++r)
+        for(register int i = 0; i < c->n; ++i)
+            sum += parlGame_handContains(&c->games[i], c->stacks[i]);
+
+    return sum;
+}
+
+static uint64_t parlBench_tiedPluralities(const ParlBenchCase* const c, const long reps)
+{
+    register uint64_t sum = 0;
+
+    for(register long r = 0; r < reps; ++r)
+        for(register int i = 0; i < c->n; ++i)
+            sum += parlGame_tiedPluralities(&c->games[i]);
+
+    return sum;
+}
+
+static uint64_t parlBench_legalActions(const ParlBenchCase* const c, const long reps)
+{
+    register uint64_t sum = 0;
+
+    for(register long r = 0; r < reps; ++r)
+        for(register int i = 0; i < c->n; ++i)
+            sum += parlGame_legalActions(&c->games[i]);
+
+    return sum;
+}
+
+static uint64_t parlBench_applyAction(const ParlBenchCase* const c, const long reps)
+{
+    register uint64_t sum = 0;
+    ParlGame g;
+
+    for(register long r = 0; r < reps; ++r)
+        for(register int i = 0; i < c->n; ++i)
+        {
+            const ParlMove m = c->moves[i];
+            parlGame_deepCopy(&g, &c->games[i]);
+            sum += parlGame_applyAction(&g, m.action, m.idxA, m.idxB, m.idxC) + g.hash;
+        }
+
+    return sum;
+}
+
+static uint64_t parlBench_deepCopy(const ParlBenchCase* const c, const long reps)
+{
+    register uint64_t sum = 0;
+    ParlGame g;
+
+    for(register long r = 0; r < reps; ++r)
+        for(register int i = 0; i < c->n; ++i)
+        {
+            parlGame_deepCopy(&g, &c->games[i]);
+            sum += g.hash;
+        }
+
+    return sum;
+}
+
+/**
+ * @return A few random cards from `s`, or `PARL_EMPTY_STACK` if it has none apart from jokers.
+ */
+static ParlStack parlBench_randomSubset(ParlStack s, ParlRng* const r)
+{
+    register ParlStack subset = PARL_EMPTY_STACK;
+
+    s = PARL_WITHOUT_JOKERS(s);
+
+    for(register int k = 1 + parlRng_below(r, 3); k > 0 && s; --k)
+    {
+        const register ParlIdx i = PARL_NTH_IDX(s, parlRng_below(r, PARL_POPCOUNT(s)));
+        subset |= PARL_CARD(i);
+        s &= ~PARL_CARD(i);
+    }
+
+    return subset;
+}
+
+/**
+ * @brief Fills in `c` from random games played with `r`.
+ */
+static void parlBench_collect(ParlBenchCorpus* const c, ParlRng* const r)
+{
+    static ParlMove moves[PARL_MAX_MOVES];
+    ParlGame g;
+
+    memset(c->numByMode, 0, sizeof c->numByMode);
+    memset(c->numByAction, 0, sizeof c->numByAction);
+
+    /* Step 1: Play random games, keeping some of the states for each mode and some of the moves for each action */
+
+    for(register int game = 0; game < PARL_BENCH_MAX_GAMES; ++game)
+    {
+        const int numPlayers = 3 + parlRng_below(r, 6),
+            numJokers = parlRng_below(r, 3);
+        const register ParlIdx firstCard = parlRng_below(r, PARL_NUM_NON_JOKER_CARDS + numJokers);
+
+        if(!parlGame_init(&g, numJokers, numPlayers, 0, PARL_IS_JOKER(firstCard) ? PARL_JOKER_IDX : firstCard))
+            continue;
+
+        for(register int ply = 0; ply <= PARL_BENCH_MAX_PLIES; ++ply)
+        {
+            register int* const numInMode = &c->numByMode[g.mode];
+
+            // Take every fourth state or so, so that the first few games don't fill up the common modes
+            if(*numInMode < PARL_BENCH_BIN_SIZE && !parlRng_below(r, 4))
+                c->byMode[g.mode][(*numInMode)++] = g;
+
+            if(g.mode == GAME_OVER || ply == PARL_BENCH_MAX_PLIES)
+                break;
+
+            register int numMoves = parlGame_generateMoves(&g, moves, PARL_MAX_MOVES);
+
+            if(!numMoves)
+                break;
+            if(numMoves > PARL_MAX_MOVES)
+                numMoves = PARL_MAX_MOVES;
+
+            const ParlMove m = moves[parlRng_below(r, numMoves)];
+            register int* const numOfAction = &c->numByAction[m.action];
+
+            if(*numOfAction < PARL_BENCH_BIN_SIZE && !parlRng_below(r, 2))
+            {
+                c->byAction[m.action][*numOfAction] = g;
+                c->actionMoves[m.action][(*numOfAction)++] = m;
+            }
+
+            if(!parlGame_applyMove(&g, m))
+                break;
+        }
+    }
+
+    /* Step 2: Gather every state and pick the cards to look for in each */
+
+    c->numAll = 0;
+
+    for(register int mode = 0; mode < PARL_BENCH_NUM_MODES; ++mode)
+        for(register int i = 0; i < c->numByMode[mode]; ++i)
+        {
+            const ParlGame* const state = &c->byMode[mode][i];
+            register ParlStack subset = parlBench_randomSubset(parlGame_possibleHand(state), r);
+
+            // Sometimes ask for a card that's definitely not there
+            if(!parlRng_below(r, 4))
+                subset |= parlBench_randomSubset(state->discard | state->parliament, r);
+
+            c->all[c->numAll] = *state;
+            c->allSubsets[c->numAll++] = subset;
+        }
+
+    /* Step 3: Make random stacks, where the second of each pair overlaps with the first */
+
+    for(register int i = 0; i < PARL_BENCH_BIN_SIZE; ++i)
+    {
+        const register ParlStack a = PARL_WITHOUT_JOKERS(parlRng_next(r)) | PARL_JOKERS(parlRng_below(r, 3));
+
+        c->stacks[2 * i] = a;
+        c->stacks[2 * i + 1] = parlBench_randomSubset(a, r) | parlBench_randomSubset(~a, r);
+    }
+}
+
+/**
+ * @brief Times `c` and prints a line of results.
+ * @param c
+ * @param stats Where to collect each sample's time per call. It must have room for `numSamples`.
+ * @param numSamples
+ * @param json
+ * @param first Whether this is the first result to be printed.
+ */
+static void parlBench_run(const ParlBenchCase* const c,
+                          ParlTimerStats* const stats,
+                          const int numSamples,
+                          const bool json,
+                          const bool first)
+{
+    ParlTimer t;
+    ParlTimerSummary summary;
+    register long reps = 1;
+    register uint64_t cycles = 0;
+
+    /* Step 1: Warm up and find how many repetitions make a sample long enough to time */
+
+    for(;; reps *= 2)
+    {
+        parlTimer_start(&t);
+        parlBench_sink += c->fn(c, reps);
+        parlTimer_stop(&t);
+
+        if(parlTimer_ns(&t) >= PARL_BENCH_MIN_SAMPLE_NS)
+            break;
+    }
+
+    /* Step 2: Take the samples */
+
+    parlTimerStats_clear(stats);
+
+    for(register int s = 0; s < numSamples; ++s)
+    {
+        parlTimer_start(&t);
+        parlBench_sink += c->fn(c, reps);
+        parlTimer_stop(&t);
+
+        parlTimerStats_add(stats, (double)parlTimer_ns(&t) / ((double)reps * c->n));
+        cycles += parlTimer_cycles(&t);
+    }
+
+    parlTimerStats_summarize(stats, &summary);
+
+    const double cyclesPerCall = (double)cycles / ((double)numSamples * reps * c->n);
+
+    if(json)
+        printf(
+            "%s\n    {\"name\": \"%s\", \"inputs\": %i, \"reps\": %li, \"min_ns\": %.3f, \"p50_ns\": %.3f, "
+            "\"p90_ns\": %.3f, \"p99_ns\": %.3f, \"max_ns\": %.3f, \"mean_ns\": %.3f, \"mean_cycles\": %.1f}",
+            first ? "" : ",", c->name, c->n, reps, summary.minNs, summary.medianNs, summary.p90Ns, summary.p99Ns,
+            summary.maxNs, summary.meanNs, cyclesPerCall
+        );
+    else
+        printf(
+            "%s,%i,%li,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f\n",
+            c->name, c->n, reps, summary.minNs, summary.medianNs, summary.p90Ns, summary.p99Ns, summary.maxNs,
+            summary.meanNs, cyclesPerCall
+        );
+
+    fflush(stdout);
+}
+
+int main(const int argc, const char* const argv[])
+{
+    static ParlBenchCorpus corpus;
+    static ParlBenchCase cases[4 + PARL_BENCH_NUM_MODES + PARL_BENCH_NUM_ACTIONS + 1];
+    register int numCases = 0;
+    bool json = false;
+    int numSamples = 101;
+    uint64_t seed = 1;
+    const char* filter = NULL;
+    ParlRng r;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        if(strcmp(argv[i], "--json") == 0)
+            json = true;
+        else if(strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+            numSamples = atoi(argv[++i]);
+        else if(strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if(strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else
+            numSamples = 0;
+    }
+
+    if(numSamples < 1)
+    {
+        fprintf(stderr, "usage: %s [--json] [--samples N] [--seed N] [--filter TEXT]\n", argv[0]);
+        return 1;
+    }
+
+    parlRng_seed(&r, seed);
+    parlBench_collect(&corpus, &r);
+
+    /* Step 1: List the benchmarks */
+
+    cases[numCases++] = (ParlBenchCase){
+        "parlStackSize", parlBench_stackSize, NULL, corpus.stacks, NULL, 2 * PARL_BENCH_BIN_SIZE
+    };
+    cases[numCases++] = (ParlBenchCase){
+        "parlRemoveCardsPartial", parlBench_removeCardsPartial, NULL, corpus.stacks, NULL, PARL_BENCH_BIN_SIZE
+    };
+    cases[numCases++] = (ParlBenchCase){
+        "parlGame_handContains", parlBench_handContains, corpus.all, corpus.allSubsets, NULL, corpus.numAll
+    };
+    cases[numCases++] = (ParlBenchCase){
+        "parlGame_tiedPluralities", parlBench_tiedPluralities, corpus.all, NULL, NULL, corpus.numAll
+    };
+
+    for(int mode = 0; mode < PARL_BENCH_NUM_MODES; ++mode)
+    {
+        ParlBenchCase* const c = &cases[numCases++];
+
+        *c = (ParlBenchCase){"", parlBench_legalActions, corpus.byMode[mode], NULL, NULL, corpus.numByMode[mode]};
+        snprintf(c->name, sizeof c->name, "parlGame_legalActions/%s", PARL_BENCH_MODE_NAMES[mode]);
+    }
+
+    for(int a = 0; a < PARL_BENCH_NUM_ACTIONS; ++a)
+    {
+        ParlBenchCase* const c = &cases[numCases++];
+
+        *c = (ParlBenchCase){
+            "", parlBench_applyAction, corpus.byAction[a], NULL, corpus.actionMoves[a], corpus.numByAction[a]
+        };
+        snprintf(c->name, sizeof c->name, "parlGame_applyAction/%s", PARL_BENCH_ACTION_NAMES[a]);
+    }
+
+    cases[numCases++] = (ParlBenchCase){
+        "parlGame_deepCopy", parlBench_deepCopy, corpus.all, NULL, NULL, corpus.numAll
+    };
+
+    /* Step 2: Run them */
+
+    ParlTimerStats stats;
+    bool first = true;
+
+    if(!parlTimerStats_init(&stats, numSamples))
+        return 1;
+
+    if(json)
+        printf("{\"seed\": %llu, \"samples\": %i, \"benchmarks\": [", (unsigned long long)seed, numSamples);
+    else
+        puts("name,inputs,reps,min_ns,p50_ns,p90_ns,p99_ns,max_ns,mean_ns,mean_cycles");
+
+    for(int i = 0; i < numCases; ++i)
+    {
+        if(filter && !strstr(cases[i].name, filter))
+            continue;
+
+        // Some modes and actions are rare enough that the random games never reach them
+        if(!cases[i].n)
+        {
+            fprintf(stderr, "skipping %s: no inputs\n", cases[i].name);
+            continue;
+        }
+
+        parlBench_run(&cases[i], &stats, numSamples, json, first);
+        first = false;
+    }
+
+    if(json)
+        puts("\n]}");
+
+    parlTimerStats_free(&stats);
+    return 0;
+}
@@ -15,15 +15,78 @@ const ParlSuit PARL_COALITION_PARTNERS[4] = {
     [HEARTS] = DIAMONDS, [DIAMONDS] = HEARTS
 };
 
-int parlStackSize(const ParlStack s)
+#define PARLIAMENT_CARDS_SUIT_MASK(suit) (((1ull << PARL_NUM_RANKS) - 1) << ((suit) * PARL_NUM_RANKS))
+
+const ParlStack PARL_SUIT_MASKS[5] = {
+    [CLUBS] = PARLIAMENT_CARDS_SUIT_MASK(CLUBS),
+    [SPADES] = PARLIAMENT_CARDS_SUIT_MASK(SPADES),
+    [HEARTS] = PARLIAMENT_CARDS_SUIT_MASK(HEARTS),
+    [DIAMONDS] = PARLIAMENT_CARDS_SUIT_MASK(DIAMONDS),
+    [PARL_JOKER_SUIT] = ~PARL_COMPLETE_STACK_NO_JOKERS
+};
+
+// One bit in each suit
+#define PARLIAMENT_CARDS_RANK_MASK(r) (( \
+    PARL_CARD(0) | PARL_CARD(PARL_NUM_RANKS) | PARL_CARD(2 * PARL_NUM_RANKS) | PARL_CARD(3 * PARL_NUM_RANKS) \
+    ) << (r))
+
+const ParlStack PARL_RANK_MASKS[13] = {
+    PARLIAMENT_CARDS_RANK_MASK(0), PARLIAMENT_CARDS_RANK_MASK(1), PARLIAMENT_CARDS_RANK_MASK(2),
+    PARLIAMENT_CARDS_RANK_MASK(3), PARLIAMENT_CARDS_RANK_MASK(4), PARLIAMENT_CARDS_RANK_MASK(5),
+    PARLIAMENT_CARDS_RANK_MASK(6), PARLIAMENT_CARDS_RANK_MASK(7), PARLIAMENT_CARDS_RANK_MASK(8),
+    PARLIAMENT_CARDS_RANK_MASK(9), PARLIAMENT_CARDS_RANK_MASK(10), PARLIAMENT_CARDS_RANK_MASK(11),
+    PARLIAMENT_CARDS_RANK_MASK(12)
+};
+
+int parlPopcount(uint64_t x)
 {
-    register int numNonJokers = 0;
+    // SWAR: count bits in pairs, then nibbles, then sum the bytes with a multiply
+    x -= (x >> 1) & 0x5555555555555555ull;
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((x * 0x0101010101010101ull) >> 56);
+}
 
-    PARL_FOREACH_IDX(i)
-        if(PARL_CONTAINS(s, PARL_CARD(i)))
-            ++numNonJokers;
+ParlIdx parlLowestIdx(const uint64_t x)
+{
+    // Isolate the lowest set bit and look up its position with a de Bruijn sequence
+    static const unsigned char DE_BRUIJN_POSITIONS[64] = {
+        0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+    };
+
+    return DE_BRUIJN_POSITIONS[((x & -x) * 0x03F79D71B4CB0A89ull) >> 58];
+}
 
-    return numNonJokers + (int)PARL_NUM_JOKERS(s);
+ParlIdx parlNthIdx(uint64_t x, unsigned int n)
+{
+    register ParlIdx base = 0;
+
+    // Narrow it down to the half, then quarter, then eighth of `x` that contains the bit
+    for(register unsigned int width = 32; width >= 8; width /= 2)
+    {
+        const register unsigned int lowCount = PARL_POPCOUNT(x & ((1ull << width) - 1));
+
+        if(n >= lowCount)
+        {
+            n -= lowCount;
+            x >>= width;
+            base += width;
+        }
+    }
+
+    // It's within the lowest byte now
+    for(; n; --n)
+        x &= x - 1;
+
+    return base + PARL_LOWEST_IDX(x);
+}
+
+int parlStackSize(const ParlStack s)
+{
+    return PARL_STACK_SIZE(s);
 }
 
 bool parlRemoveCards(ParlStack* const orig, const ParlStack cards)
@@ -37,8 +100,12 @@ bool parlRemoveCards(ParlStack* const orig, const ParlStack cards)
 
 void parlRemoveCardsPartial(ParlStack* const orig, const ParlStack cards)
 {
+#if PARL_DISTINCT_JOKERS
+    *orig &= ~cards;
+#else
     *orig = PARL_WITHOUT_JOKERS(*orig - (*orig & cards))
         + PARL_JOKER_CARD * (PARL_NUM_JOKERS(*orig) - PARL_NUM_JOKERS(cards));
+#endif
 }
 
 bool parlMoveCards(ParlStack* const dest, ParlStack* const orig, const ParlStack cards)
@@ -86,7 +153,7 @@ ParlIdx parlSymbolToIdx(const ParlCardSymbol symbol)
     ParlRank rank;
     ParlSuit suit = PARL_PARSE_ERROR;
 
-    if(strcmp(symbol, PARL_JOKER_SYMBOL) == 0)
+    if(memcmp(symbol, PARL_JOKER_SYMBOL, PARL_SYMBOL_WIDTH) == 0)
         return PARL_JOKER_IDX;
 
     /* Parse rank */
@@ -13,8 +13,11 @@
  * Internally, this is implemented by treating each card in a stack of cards (ParlStack = uint_64) as a flag that can be
  * set to indicate the card exists in the stack. The 52 rightmost bits in the integer indicate the status of the 52
  * non-joker cards. The number of jokers in the card can be obtained with PARL_NUM_JOKERS(), which simply right-shifts
- * the 52 non-joker bits away. Jokers have to be implemented like this because they are not unique. This API would be
- * much faster if the different jokers were considered to be different cards.
+ * the 52 non-joker bits away. Jokers are implemented like this by default because they are not unique.
+ *
+ * If PARL_DISTINCT_JOKERS is 1, each joker instead gets its own bit above the non-joker cards, so that every stack
+ * operation is a plain bitwise one. The jokers are still interchangeable: `PARL_JOKER_IDX` as an action argument means
+ * "a joker", and `parlMatchJoker` picks which one.
  *
  * TODO I haven't bothered to explain how to use any of the code in here -- would be helpful
  */
@@ -36,6 +39,24 @@
 
 #define PARL_JOKER_CARD (PARL_CARD(PARL_JOKER_IDX))
 
+/**
+ * Whether each joker has its own bit in a `ParlStack` (1) or jokers are counted (0). Set it with the
+ * PARL_DISTINCT_JOKERS option in CMakeLists.txt.
+ *
+ * With distinct jokers, joker `n` is the card `PARL_JOKER_IDX + n`, so there can be at most `PARL_MAX_JOKERS` of them.
+ * The last bit is left unused because its index, 63, is the all-ones `ParlIdx` that stands for "no card" in a 6-bit
+ * field.
+ */
+#ifndef PARL_DISTINCT_JOKERS
+#define PARL_DISTINCT_JOKERS 0
+#endif
+
+#if PARL_DISTINCT_JOKERS
+#define PARL_MAX_JOKERS (63 - PARL_JOKER_IDX)
+#else
+#define PARL_MAX_JOKERS ((1 << (64 - PARL_JOKER_IDX)) - 1)
+#endif
+
 #define PARL_NUM_NON_JOKER_CARDS PARL_JOKER_IDX
 #define PARL_NUM_SUITS PARL_JOKER_SUIT
 #define PARL_NUM_RANKS PARL_JOKER_RANK
@@ -118,23 +139,52 @@
 /**
  * Returns whether s0 contains the entirety of s1.
  */
+#if PARL_DISTINCT_JOKERS
+#define PARL_CONTAINS(s0, s1) (((s0) & (s1)) == (s1))
+#else
 #define PARL_CONTAINS(s0, s1) ( \
     /* Excluding jokers, the cards that s0 and s1 share is the entirety of s1 */ \
     PARL_WITHOUT_JOKERS((s0) & (s1)) == PARL_WITHOUT_JOKERS(s1)                  \
     /* s0 has at least as many jokers as s1 */ \
     && PARL_NUM_JOKERS(s0) >= PARL_NUM_JOKERS(s1))
+#endif
 
 /**
  * Filter a stack to only cards of a given suit.
  */
-#define PARL_FILTER_SUIT(s, suit) ((s) & ( \
-    PARL_CARD(PARL_NUM_RANKS * ((suit) + 1)) - PARL_CARD(PARL_NUM_RANKS * (suit)) \
-    ))
+#define PARL_FILTER_SUIT(s, suit) ((s) & PARL_SUIT_MASKS[suit])
+
+/**
+ * Filter a stack to only cards of a given rank, not including jokers.
+ */
+#define PARL_FILTER_RANK(s, r) ((s) & PARL_RANK_MASKS[r])
 
 /**
  * Returns the number of jokers in a stack.
  */
+#if PARL_DISTINCT_JOKERS
+#define PARL_NUM_JOKERS(s) ((unsigned int)PARL_POPCOUNT((s) >> PARL_JOKER_IDX))
+#else
 #define PARL_NUM_JOKERS(s) ((s) >> PARL_JOKER_IDX)
+#endif
+
+/**
+ * Returns a stack of `n` jokers and nothing else. With distinct jokers, these are the first `n` of them.
+ */
+#if PARL_DISTINCT_JOKERS
+#define PARL_JOKERS(n) ((((ParlStack)1 << (n)) - 1) << PARL_JOKER_IDX)
+#else
+#define PARL_JOKERS(n) ((ParlStack)(n) << PARL_JOKER_IDX)
+#endif
+
+/**
+ * Returns the index of one of the jokers in `s`, which must have at least one.
+ */
+#if PARL_DISTINCT_JOKERS
+#define PARL_ANY_JOKER_IDX(s) (PARL_JOKER_IDX + PARL_LOWEST_IDX((s) >> PARL_JOKER_IDX))
+#else
+#define PARL_ANY_JOKER_IDX(s) PARL_JOKER_IDX
+#endif
 
 /**
  * Iterates through all 4 suits, not including the joker suit.
@@ -157,11 +207,159 @@
 #define PARL_FOREACH_IDX(i) for(register ParlIdx i = 0; i < PARL_NUM_NON_JOKER_CARDS; ++i)
 
 /**
- * Iterates through all indices of all cards in the stack `s`.
+ * Returns the number of set bits in `x`.
+ */
+#define PARL_POPCOUNT(x) PARL_POPCOUNT_IMPL(x)
+
+/**
+ * Returns the index of the lowest set bit in `x`. Undefined if `x` is 0.
+ */
+#define PARL_LOWEST_IDX(x) PARL_LOWEST_IDX_IMPL(x)
+
+#if defined(__GNUC__) || defined(__clang__)
+// These compile down to single popcnt/tzcnt instructions when the target supports them (see PARL_NATIVE in
+// CMakeLists.txt) and to a short branchless sequence otherwise.
+#define PARL_POPCOUNT_IMPL(x) __builtin_popcountll(x)
+#define PARL_LOWEST_IDX_IMPL(x) ((ParlIdx)__builtin_ctzll(x))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#define PARL_POPCOUNT_IMPL(x) ((int)__popcnt64(x))
+#define PARL_LOWEST_IDX_IMPL(x) parlLowestIdx(x)
+#else
+#define PARL_POPCOUNT_IMPL(x) parlPopcount(x)
+#define PARL_LOWEST_IDX_IMPL(x) parlLowestIdx(x)
+#endif
+
+/**
+ * Returns the index of the set bit in `x` that has exactly `n` set bits below it, so `n` = 0 is the lowest set bit.
+ * Undefined if `x` has `n` or fewer set bits.
+ */
+#define PARL_NTH_IDX(x, n) PARL_NTH_IDX_IMPL(x, n)
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+// pdep deposits a single bit into the nth set position of x in one instruction
+#define PARL_NTH_IDX_IMPL(x, n) PARL_LOWEST_IDX(_pdep_u64(1ull << (n), (x)))
+#else
+#define PARL_NTH_IDX_IMPL(x, n) parlNthIdx((x), (n))
+#endif
+
+/**
+ * Returns the number of cards in the stack `s`, including jokers.
+ */
+#if PARL_DISTINCT_JOKERS
+#define PARL_STACK_SIZE(s) PARL_POPCOUNT(s)
+#else
+#define PARL_STACK_SIZE(s) (PARL_POPCOUNT(PARL_WITHOUT_JOKERS(s)) + (int)PARL_NUM_JOKERS(s))
+#endif
+
+/* Rank masks -- a set of ranks as 13 bits, with the ace in bit 0. Since each suit is 13 consecutive bits of a stack, a
+ * suit's cards can be turned into a rank mask with a shift, and comparing ranks across a whole stack takes only a few
+ * mask operations. */
+
+/**
+ * Returns the rank mask of every rank.
+ */
+#define PARL_ALL_RANKS ((1ull << PARL_NUM_RANKS) - 1)
+
+/**
+ * Returns the ranks of the cards of suit `suit` in the stack `s`.
+ */
+#define PARL_SUIT_RANKS(s, suit) ((s) >> ((suit) * PARL_NUM_RANKS) & PARL_ALL_RANKS)
+
+/**
+ * Returns the ranks that at least one non-joker card in the stack `s` has.
+ */
+#define PARL_RANKS_IN(s) \
+    (PARL_SUIT_RANKS(s, 0) | PARL_SUIT_RANKS(s, 1) | PARL_SUIT_RANKS(s, 2) | PARL_SUIT_RANKS(s, 3))
+
+/**
+ * Returns the ranks that at least three non-joker cards in the stack `s` have, which is those set in 3 of its 4 suits.
+ */
+#define PARL_RANKS_IN_THREE_SUITS(s) ( \
+    (PARL_SUIT_RANKS(s, 0) & PARL_SUIT_RANKS(s, 1) & (PARL_SUIT_RANKS(s, 2) | PARL_SUIT_RANKS(s, 3))) \
+    | (PARL_SUIT_RANKS(s, 2) & PARL_SUIT_RANKS(s, 3) & (PARL_SUIT_RANKS(s, 0) | PARL_SUIT_RANKS(s, 1))))
+
+/**
+ * Returns the ranks above the rank `r`. This is empty for kings and jokers.
+ */
+#define PARL_RANKS_ABOVE(r) (PARL_ALL_RANKS << ((r) + 1) & PARL_ALL_RANKS)
+
+/**
+ * @param ranks A rank mask.
+ * @return Every rank at or below the highest rank in `ranks`, or nothing if `ranks` is empty. This is a prefix-OR of
+ * the highest bit downwards.
+ */
+static inline uint64_t parlRanksUpToHighest(register uint64_t ranks)
+{
+    ranks |= ranks >> 1;
+    ranks |= ranks >> 2;
+    ranks |= ranks >> 4;
+    ranks |= ranks >> 8;
+    return ranks;
+}
+
+/* Rank-major stacks -- see `ParlRankStack` */
+
+/**
+ * Returns the bit of the card of rank `r` and suit `s` in a `ParlRankStack`.
+ */
+#define PARL_RS_TO_RANK_MAJOR_IDX(r, s) ((r) * PARL_NUM_SUITS + (s))
+
+/**
+ * Returns every non-joker card of a `ParlRankStack`, which is the low bit of each of its 13 suit sets set.
+ */
+#define PARL_RANK_MAJOR_LOW_BITS 0x1111111111111ull
+
+/**
+ * Returns the suits of the cards of rank `r` in the `ParlRankStack` `rs` as a 4-bit suit set.
+ */
+#define PARL_RANK_MAJOR_SUITS(rs, r) ((rs) >> ((r) * PARL_NUM_SUITS) & 0xF)
+
+/**
+ * Returns every non-joker card of a rank above `r` in a `ParlRankStack`. This is empty for kings and jokers.
+ */
+#define PARL_RANK_MAJOR_ABOVE(r) \
+    (~0ull << ((r) + 1) * PARL_NUM_SUITS & (PARL_RANK_MAJOR_LOW_BITS * 0xF))
+
+/**
+ * Returns the ranks that at least three cards in the `ParlRankStack` `rs` have, as the lowest bit of each rank's suit
+ * set. Like `PARL_RANKS_IN_THREE_SUITS`, but each rank is tested within its own 4 bits.
+ */
+#define PARL_RANK_MAJOR_TRIPLES(rs) ( \
+    ((((rs) & (rs) >> 1) & ((rs) | (rs) >> 1) >> 2) \
+    | ((((rs) & (rs) >> 1) >> 2) & ((rs) | (rs) >> 1))) \
+    & PARL_RANK_MAJOR_LOW_BITS)
+
+/**
+ * Returns the lowest index of a non-joker card in `s` that is at least `start`, or `PARL_NUM_NON_JOKER_CARDS` if there
+ * is none. `start` must not be greater than `PARL_NUM_NON_JOKER_CARDS`.
+ */
+#define PARL_FIRST_IDX_FROM(s, start) PARL_LOWEST_IDX( \
+    /* The joker bit acts as a sentinel so that this is never called on 0 */ \
+    (PARL_WITHOUT_JOKERS(s) & (~PARL_EMPTY_STACK << (start))) | PARL_JOKER_CARD)
+
+/**
+ * Iterates through all indices of all non-joker cards in the stack `s` in ascending order. Only the cards that are
+ * present are visited, so this costs one bit scan per card rather than one step per index.
  */
 #define PARL_FOREACH_IN_STACK(s, i) \
-    PARL_FOREACH_IDX(i) \
-        if(PARL_CONTAINS((s), PARL_CARD(i)))
+    for( \
+        register ParlIdx i = PARL_FIRST_IDX_FROM((s), 0); \
+        i < PARL_NUM_NON_JOKER_CARDS; \
+        i = PARL_FIRST_IDX_FROM((s), i + 1) \
+    )
+
+/**
+ * Like `PARL_FOREACH_IN_STACK`, but also visits `PARL_JOKER_IDX` once at the end if `s` contains any jokers. With
+ * distinct jokers, this stands for whichever joker the action is applied to (see `parlMatchJoker`).
+ */
+#define PARL_FOREACH_KIND_IN_STACK(s, i) \
+    for( \
+        register ParlIdx i = PARL_FIRST_IDX_FROM((s), 0); \
+        i < PARL_NUM_NON_JOKER_CARDS || (i == PARL_JOKER_IDX && PARL_NUM_JOKERS(s)); \
+        i = i < PARL_JOKER_IDX ? PARL_FIRST_IDX_FROM((s), i + 1) : PARL_JOKER_IDX + 1 \
+    )
 /**
  * An integer that uniquely identifies a card.
  *
@@ -197,6 +395,16 @@ typedef unsigned int ParlRank;
  */
 typedef uint64_t ParlStack;
 
+/**
+ * The same cards as a `ParlStack`, but with the non-joker cards ordered by rank first: the card of rank `r` and suit `s`
+ * is bit `r * 4 + s`. Each rank's cards are then 4 consecutive bits, so per-rank questions like "which cards outrank
+ * this one" or "which ranks have three cards" take a shift and a mask. Jokers are counted the same way as in a
+ * `ParlStack`, so `PARL_NUM_JOKERS` works on both.
+ *
+ * Convert with `parlToRankMajor` and `parlFromRankMajor`.
+ */
+typedef uint64_t ParlRankStack;
+
 /**
  * The suit of a `ParlIdx`.
  */
@@ -211,12 +419,127 @@ typedef enum
 /**
  * The symbol that represents a joker.
  */
-const ParlCardSymbol PARL_JOKER_SYMBOL;
+extern const ParlCardSymbol PARL_JOKER_SYMBOL;
 
 /**
  * Coalition partners for each `ParlSuit`.
  */
-const ParlSuit PARL_COALITION_PARTNERS[4];
+extern const ParlSuit PARL_COALITION_PARTNERS[4];
+
+/**
+ * All 13 cards of each suit. The entry for `PARL_JOKER_SUIT` covers the jokers.
+ */
+extern const ParlStack PARL_SUIT_MASKS[5];
+
+/**
+ * All 4 cards of each rank, not including jokers.
+ */
+extern const ParlStack PARL_RANK_MASKS[13];
+
+/**
+ * @param ranks A rank mask.
+ * @return `ranks` with each bit moved to the lowest bit of its rank's suit set in a `ParlRankStack`.
+ */
+static inline uint64_t parlSpreadRanks(register uint64_t ranks)
+{
+#if defined(__BMI2__)
+    return _pdep_u64(ranks, PARL_RANK_MAJOR_LOW_BITS);
+#else
+    // Split into halves, then quarters, and so on, until each bit is 4 apart
+    ranks = (ranks | ranks << 24) & 0x000000FF000000FFull;
+    ranks = (ranks | ranks << 12) & 0x000F000F000F000Full;
+    ranks = (ranks | ranks << 6) & 0x0303030303030303ull;
+    ranks = (ranks | ranks << 3) & 0x1111111111111111ull;
+    return ranks;
+#endif
+}
+
+/**
+ * @param spread The lowest bit of each suit set of a `ParlRankStack`. Other bits are ignored.
+ * @return The rank mask of the set bits. This undoes `parlSpreadRanks`.
+ */
+static inline uint64_t parlGatherRanks(register uint64_t spread)
+{
+#if defined(__BMI2__)
+    return _pext_u64(spread, PARL_RANK_MAJOR_LOW_BITS);
+#else
+    spread &= PARL_RANK_MAJOR_LOW_BITS;
+    spread = (spread | spread >> 3) & 0x0303030303030303ull;
+    spread = (spread | spread >> 6) & 0x000F000F000F000Full;
+    spread = (spread | spread >> 12) & 0x000000FF000000FFull;
+    spread = (spread | spread >> 24) & PARL_ALL_RANKS;
+    return spread;
+#endif
+}
+
+/**
+ * @param s
+ * @return `s` as a `ParlRankStack`.
+ */
+static inline ParlRankStack parlToRankMajor(const ParlStack s)
+{
+    register ParlRankStack rs = PARL_WITHOUT_JOKERS(s) ^ s;
+
+    PARL_FOREACH_SUIT(suit)
+        rs |= parlSpreadRanks(PARL_SUIT_RANKS(s, suit)) << suit;
+
+    return rs;
+}
+
+/**
+ * @param rs
+ * @return `rs` as a `ParlStack`. This undoes `parlToRankMajor`.
+ */
+static inline ParlStack parlFromRankMajor(const ParlRankStack rs)
+{
+    register ParlStack s = PARL_WITHOUT_JOKERS(rs) ^ rs;
+
+    PARL_FOREACH_SUIT(suit)
+        s |= parlGatherRanks(rs >> suit) << (suit * PARL_NUM_RANKS);
+
+    return s;
+}
+
+/**
+ * Matches a card index that is meant to be in `s` to one that actually is. Jokers are interchangeable, so with
+ * distinct jokers, any joker that isn't in `s` is swapped for one that is, if there is one. Counted jokers all have the
+ * same index already, so then this always returns `i`.
+ * @param i
+ * @param s
+ * @return The index of the card to take from `s`.
+ */
+static inline ParlIdx parlMatchJoker(const ParlIdx i, const ParlStack s)
+{
+#if PARL_DISTINCT_JOKERS
+    if(PARL_IS_JOKER(i) && i < 64 && !(s & PARL_CARD(i)) && PARL_NUM_JOKERS(s))
+        return PARL_ANY_JOKER_IDX(s);
+#else
+    (void)s;
+#endif
+    return i;
+}
+
+/**
+ * Portable fallback for `PARL_POPCOUNT`.
+ * @param x
+ * @return The number of set bits in `x`.
+ */
+int parlPopcount(uint64_t x);
+
+/**
+ * Portable fallback for `PARL_LOWEST_IDX`.
+ * @param x Must not be 0.
+ * @return The index of the lowest set bit in `x`.
+ */
+ParlIdx parlLowestIdx(uint64_t x);
+
+/**
+ * Portable fallback for `PARL_NTH_IDX`.
+ * @param x Must have more than `n` set bits.
+ * @param n
+ * @return The index of the set bit in `x` that has exactly `n` set bits below it.
+ */
+ParlIdx parlNthIdx(uint64_t x, unsigned int n);
 
 /**
  * @param s
@@ -0,0 +1,236 @@
+#include "endgame.h"
+#include "perfect.h"
+
+/**
+ * Mixed into the hash of a position to tell apart the results solved for different players.
+ */
+#define PARL_ENDGAME_PLAYER_KEY(me) (((uint64_t)(me) + 1) * 0x9E3779B97F4A7C15ull)
+
+static bool parlEndgame_sameMove(const ParlMove a, const ParlMove b)
+{
+    return a.action == b.action && a.idxA == b.idxA && a.idxB == b.idxB && a.idxC == b.idxC;
+}
+
+/**
+ * @brief Alpha-beta search from `me`'s point of view, where `me` picks the best move for themselves and every other
+ * player picks the worst move for `me`.
+ * @param s
+ * @param g Left as it was.
+ * @param me
+ * @param ply The number of moves from the position that's being solved, which picks the buffer in `s->moves`.
+ * @param alpha
+ * @param beta
+ * @param height Where to write the length of the longest line searched from `g`, which decides what's kept in `s->tt`.
+ * @param best If not `NULL`, where to write the move that the value comes from.
+ * @return The value of `g` if it's strictly between `alpha` and `beta`, otherwise a bound on it on the same side.
+ */
+static int parlEndgame_search(ParlEndgameSolver* const s,
+                              ParlGame* const g,
+                              const ParlPlayer me,
+                              const int ply,
+                              register int alpha,
+                              register int beta,
+                              int* const height,
+                              ParlMove* const best)
+{
+    *height = 0;
+
+    if(g->mode == GAME_OVER)
+        return g->turn == me ? PARL_ENDGAME_WIN : PARL_ENDGAME_LOSS;
+
+    // Parliament was dissolved, so the game goes on with a new draw deck
+    if(!PARL_ENDGAME_PHASE(g) || ply == PARL_ENDGAME_MAX_DEPTH)
+        return PARL_ENDGAME_DISSOLVED;
+
+    const uint64_t key = g->hash ^ PARL_ENDGAME_PLAYER_KEY(me);
+    ParlTTData d;
+    register bool hasTtMove = false;
+
+    if(parlTT_probe(&s->tt, key, &d))
+    {
+        const register int value = (int)d.value;
+
+        if(d.bound == PARL_TT_EXACT
+            || (d.bound == PARL_TT_LOWER && value >= beta)
+            || (d.bound == PARL_TT_UPPER && value <= alpha))
+        {
+            *height = d.depth;
+
+            if(best)
+                *best = d.bestMove;
+
+            return value;
+        }
+
+        hasTtMove = true;
+    }
+
+    ++s->nodes;
+
+    ParlMove* const moves = s->moves[ply];
+    register int numMoves = parlGame_generateMoves(g, moves, PARL_ENDGAME_MAX_MOVES);
+
+    if(numMoves > PARL_ENDGAME_MAX_MOVES)
+        numMoves = PARL_ENDGAME_MAX_MOVES;
+
+    // Try the move that was best last time first, since it most likely still is
+    if(hasTtMove)
+        for(register int i = 1; i < numMoves; ++i)
+            if(parlEndgame_sameMove(moves[i], d.bestMove))
+            {
+                moves[i] = moves[0];
+                moves[0] = d.bestMove;
+                break;
+            }
+
+    const bool maximizing = g->turn == me;
+    const int origAlpha = alpha, origBeta = beta;
+    register int bestValue = maximizing ? PARL_ENDGAME_LOSS - 1 : PARL_ENDGAME_WIN + 1;
+    ParlMove bestMove = moves[0];
+    ParlUndo undo;
+
+    for(register int i = 0; i < numMoves && alpha < beta; ++i)
+    {
+        int childHeight;
+
+        if(!parlGame_applyMoveUndoable(g, &undo, moves[i]))
+            continue;
+
+        const register int value = parlEndgame_search(s, g, me, ply + 1, alpha, beta, &childHeight, NULL);
+        parlGame_undoAction(g, &undo);
+
+        if(childHeight + 1 > *height)
+            *height = childHeight + 1;
+
+        if(maximizing ? value > bestValue : value < bestValue)
+        {
+            bestValue = value;
+            bestMove = moves[i];
+
+            if(maximizing && value > alpha)
+                alpha = value;
+            else if(!maximizing && value < beta)
+                beta = value;
+        }
+    }
+
+    // No legal moves, which shouldn't happen in the endgame
+    if(bestValue < PARL_ENDGAME_LOSS || bestValue > PARL_ENDGAME_WIN)
+        return PARL_ENDGAME_DISSOLVED;
+
+    d = (ParlTTData){
+        .value = (float)bestValue,
+        .visits = 0,
+        .bestMove = bestMove,
+        .depth = *height,
+        .bound = bestValue <= origAlpha ? PARL_TT_UPPER : bestValue >= origBeta ? PARL_TT_LOWER : PARL_TT_EXACT
+    };
+    parlTT_store(&s->tt, key, &d);
+
+    if(best)
+        *best = bestMove;
+
+    return bestValue;
+}
+
+bool parlEndgame_init(ParlEndgameSolver* const s, const size_t ttBytes)
+{
+    s->nodes = 0;
+    return parlTT_init(&s->tt, ttBytes);
+}
+
+void parlEndgame_free(ParlEndgameSolver* const s)
+{
+    parlTT_free(&s->tt);
+}
+
+int parlEndgame_solve(ParlEndgameSolver* const s, const ParlGame* const g, const ParlPlayer me, ParlMove* const best)
+{
+    ParlGame copy = *g;
+    int height;
+
+    s->nodes = 0;
+    parlTT_newSearch(&s->tt);
+
+    return parlEndgame_search(s, &copy, me, 0, PARL_ENDGAME_LOSS, PARL_ENDGAME_WIN, &height, best);
+}
+
+bool parlEndgame_solveSampled(ParlEndgameSolver* const s,
+                              const ParlGame* const g,
+                              const int numWorlds,
+                              ParlRng* const r,
+                              ParlMove* const best,
+                              float* const value)
+{
+    // The moves seen at the root of any deal, with the total and count of their values
+    ParlMove moves[PARL_ENDGAME_MAX_MOVES];
+    int totals[PARL_ENDGAME_MAX_MOVES] = {0}, counts[PARL_ENDGAME_MAX_MOVES] = {0};
+    register int numMoves = 0;
+
+    ParlWorld world;
+    ParlPerfectGame pg;
+    ParlUndo undo;
+
+    if(!PARL_ENDGAME_PHASE(g))
+        return false;
+
+    s->nodes = 0;
+    parlTT_newSearch(&s->tt);
+
+    for(register int w = 0; w < numWorlds; ++w)
+    {
+        if(!parlWorld_sample(&world, g, r))
+            continue;
+
+        parlPerfect_fromWorld(&pg, g, &world, parlRng_next(r));
+
+        ParlMove* const worldMoves = s->moves[0];
+        register int numWorldMoves = parlGame_generateMoves(&pg.g, worldMoves, PARL_ENDGAME_MAX_MOVES);
+
+        if(numWorldMoves > PARL_ENDGAME_MAX_MOVES)
+            numWorldMoves = PARL_ENDGAME_MAX_MOVES;
+
+        for(register int i = 0; i < numWorldMoves; ++i)
+        {
+            const ParlMove m = worldMoves[i];
+            int height;
+
+            if(!parlGame_applyMoveUndoable(&pg.g, &undo, m))
+                continue;
+
+            const register int v = parlEndgame_search(s, &pg.g, g->turn, 1, PARL_ENDGAME_LOSS, PARL_ENDGAME_WIN,
+                                                      &height, NULL);
+            parlGame_undoAction(&pg.g, &undo);
+
+            register int j = 0;
+
+            while(j < numMoves && !parlEndgame_sameMove(moves[j], m))
+                ++j;
+
+            if(j == numMoves)
+            {
+                // A move that no earlier deal had room for is dropped
+                if(numMoves == PARL_ENDGAME_MAX_MOVES)
+                    continue;
+
+                moves[numMoves++] = m;
+            }
+
+            totals[j] += v;
+            ++counts[j];
+        }
+    }
+
+    register int bestIdx = -1;
+
+    for(register int j = 0; j < numMoves; ++j)
+        if(bestIdx < 0 || (float)totals[j] / counts[j] > (float)totals[bestIdx] / counts[bestIdx])
+            bestIdx = j;
+
+    if(bestIdx < 0)
+        return false;
+
+    *best = moves[bestIdx];
+    *value = (float)totals[bestIdx] / counts[bestIdx];
+    return true;
+}
@@ -0,0 +1,110 @@
+/**
+ * @file
+ * @brief An exact solver for the endgame, from when the draw deck runs out until a coalition forms or Parliament is
+ * dissolved.
+ *
+ * @details
+ * The endgame is the modes from `PM_CHOOSE_FIRST_LAST_MODE` to `COUNTER_BLOCK_COALITION_MODE`. Nothing is drawn in
+ * them, so once every hand is known, what happens only depends on the players' choices, and there are only a few to
+ * make: which PM candidate to try forming a government with or whether to pass, and whether to block or counter-block
+ * a coalition. It ends either with `GAME_OVER` or with Parliament dissolved and the game back in `NORMAL_MODE`.
+ *
+ * `parlEndgame_solve` searches every line of play to the end of the endgame with alpha-beta, from the point of view of
+ * one player, assuming everyone else plays against them. Its result is exact: `PARL_ENDGAME_WIN` means that player
+ * wins no matter what the others do, `PARL_ENDGAME_LOSS` means the others can make one of them win, and
+ * `PARL_ENDGAME_DISSOLVED` is anything in between. Solved positions are kept in a `ParlTT`, so the many lines that
+ * reach the same position are only searched once, including across calls.
+ *
+ * When hands are hidden, `parlEndgame_solveSampled` deals them out with `parlWorld_sample` and averages the solved
+ * value of each move over the deals.
+ */
+
+#ifndef PARLIAMENT_ENDGAME_H
+#define PARLIAMENT_ENDGAME_H
+
+#include "game.h"
+#include "rng.h"
+#include "tt.h"
+
+#define PARL_ENDGAME_WIN 1
+#define PARL_ENDGAME_DISSOLVED 0
+#define PARL_ENDGAME_LOSS (-1)
+
+/**
+ * The most moves deep the endgame is searched. Every block uses up a card, so no endgame comes anywhere near this.
+ */
+#define PARL_ENDGAME_MAX_DEPTH 256
+
+/**
+ * The most moves considered in one position. An endgame move plays at most one card from a hand of at most
+ * `PARL_MAX_CARDS_IN_HAND` cards, or none.
+ */
+#define PARL_ENDGAME_MAX_MOVES 16
+
+/**
+ * @param g
+ * @return Whether `g` is in one of the modes of the endgame.
+ */
+#define PARL_ENDGAME_PHASE(g) ((g)->mode == ENDGAME_MODE \
+    || (g)->mode == PM_CHOOSE_FIRST_LAST_MODE            \
+    || (g)->mode == BLOCK_COALITION_MODE                 \
+    || (g)->mode == COUNTER_BLOCK_COALITION_MODE)
+
+typedef struct ParlEndgameSolver
+{
+    /**
+     * Solved positions. The hashes they're stored under also depend on whose point of view they were solved from.
+     */
+    ParlTT tt;
+
+    /**
+     * Scratch space for the moves of each position on the current line, one buffer per ply.
+     */
+    ParlMove moves[PARL_ENDGAME_MAX_DEPTH][PARL_ENDGAME_MAX_MOVES];
+
+    /**
+     * The number of positions searched by the last call to `parlEndgame_solve` or `parlEndgame_solveSampled`, not
+     * counting ones found in `tt`.
+     */
+    unsigned long nodes;
+} ParlEndgameSolver;
+
+/**
+ * @param s
+ * @param ttBytes The most memory the table of solved positions may use.
+ * @return Whether the initialization was successful.
+ */
+bool parlEndgame_init(ParlEndgameSolver* s, size_t ttBytes);
+
+/**
+ * @brief Frees the memory allocated for `s`, not including the `ParlEndgameSolver` struct itself.
+ * @param s
+ */
+void parlEndgame_free(ParlEndgameSolver* s);
+
+/**
+ * @brief Solves an endgame in which every hand is known.
+ * @param s
+ * @param g A game with `allHandsKnown`, such as `ParlPerfectGame.g`, that's in the endgame or over.
+ * @param me The player to solve for.
+ * @param best If not `NULL`, where to write a move that gets `me` the result, if `g` has any moves. When it isn't
+ * `me`'s turn, this is the move that's worst for `me`.
+ * @return `PARL_ENDGAME_WIN`, `PARL_ENDGAME_DISSOLVED`, or `PARL_ENDGAME_LOSS`.
+ */
+int parlEndgame_solve(ParlEndgameSolver* s, const ParlGame* g, ParlPlayer me, ParlMove* best);
+
+/**
+ * @brief Picks a move in an endgame where some hands are hidden, for the player whose turn it is, by solving many
+ * deals of the hidden cards.
+ * @param s
+ * @param g A game in the endgame.
+ * @param numWorlds How many deals to solve.
+ * @param r
+ * @param best Where to write the move with the highest average value.
+ * @param value Where to write that average value, between `PARL_ENDGAME_LOSS` and `PARL_ENDGAME_WIN`.
+ * @return Whether there was a move to pick, which is false if `g` isn't in the endgame or couldn't be dealt.
+ */
+bool parlEndgame_solveSampled(ParlEndgameSolver* s, const ParlGame* g, int numWorlds, ParlRng* r, ParlMove* best,
+                              float* value);
+
+#endif //PARLIAMENT_ENDGAME_H
@@ -7,11 +7,108 @@
  */
 
 #include "game.h"
+#include "zobrist.h"
 
-#include <stdlib.h>
 #include <string.h>
 
-#define DECREASE_HAND_SIZE(n) g->handSizes[g->turn] -= n
+/**
+ * Sets the field `member` of `g` that is keyed as `field` of player `p` to `value`, and XORs the change into `g->hash`.
+ * The new value is read back so that it's hashed the way it was stored, for bitfields that `value` doesn't fit in.
+ */
+#define PARL_SET_OF(field, p, member, value) do                                                         \
+    {                                                                                                   \
+        const register unsigned int parlOld = g->member;                                                \
+        g->member = (value);                                                                            \
+        if(parlOld != (unsigned int)g->member)                                                          \
+            g->hash ^= parlZobrist_key(field, p, parlOld) ^ parlZobrist_key(field, p, g->member);       \
+    } while(0)
+
+/**
+ * Sets the stack `member` of `g` that is keyed as `field` of player `p` to `value`, and XORs the change into `g->hash`.
+ */
+#define PARL_SET_STACK_OF(field, p, member, value) do                                                   \
+    {                                                                                                   \
+        const register ParlStack parlNew = (value);                                                     \
+        g->hash ^= parlZobrist_stackDiff(field, p, g->member, parlNew);                                 \
+        g->member = parlNew;                                                                            \
+    } while(0)
+
+#define PARL_SET(field, member, value) PARL_SET_OF(field, 0, member, value)
+#define PARL_SET_STACK(field, member, value) PARL_SET_STACK_OF(field, 0, member, value)
+
+#define DECREASE_HAND_SIZE(n) \
+    PARL_SET_OF(PARL_ZOBRIST_HAND_SIZE, g->turn, handSizes[g->turn], g->handSizes[g->turn] - (n))
+
+/**
+ * @return The key field of `s`, which must point to one of the stacks of `g` that aren't per-player.
+ */
+static unsigned int parlGame_stackField(const ParlGame* const g, const ParlStack* const s)
+{
+    if(s == &g->parliament)
+        return PARL_ZOBRIST_PARLIAMENT;
+    if(s == &g->cabinet)
+        return PARL_ZOBRIST_CABINET;
+    if(s == &g->discard)
+        return PARL_ZOBRIST_DISCARD;
+    return PARL_ZOBRIST_FACE_DOWN;
+}
+
+/**
+ * @brief `parlMoveCards` between two of the stacks of `g` that aren't per-player, keeping `g->hash` up to date.
+ */
+static bool parlGame_moveCards(ParlGame* const g, ParlStack* const dest, ParlStack* const orig, const ParlStack cards)
+{
+    const register ParlStack destBefore = *dest, origBefore = *orig;
+
+    if(!parlMoveCards(dest, orig, cards))
+        return false;
+
+    g->hash ^= parlZobrist_stackDiff(parlGame_stackField(g, dest), 0, destBefore, *dest)
+        ^ parlZobrist_stackDiff(parlGame_stackField(g, orig), 0, origBefore, *orig);
+    return true;
+}
+
+/**
+ * @brief Empties player `p`'s election candidacy.
+ */
+static void parlGame_clearElecCand(ParlGame* const g, const ParlPlayer p)
+{
+    PARL_SET_STACK_OF(PARL_ZOBRIST_CALLING_CARDS, p, elecCands[p].callingCards, PARL_EMPTY_STACK);
+    PARL_SET_OF(PARL_ZOBRIST_CAND_PM, p, elecCands[p].pmIdx, 0);
+    PARL_SET_OF(PARL_ZOBRIST_CAND_PRE_CALL_NUM_CARDS, p, elecCands[p].preCallNumCards, 0);
+}
+
+/**
+ * @brief Sets `pluralities` from `parliamentSuitSizes`.
+ */
+static void parlGame_updatePluralities(ParlGame* const g)
+{
+    register unsigned int tiedPluralities = 0;
+    register int pluralitySuitSize = 0;
+
+    PARL_FOREACH_SUIT(s)
+    {
+        if(g->parliamentSuitSizes[s] > pluralitySuitSize)
+        {
+            pluralitySuitSize = g->parliamentSuitSizes[s];
+            tiedPluralities = 1u << s;
+        }
+        else if(g->parliamentSuitSizes[s] == pluralitySuitSize)
+            tiedPluralities |= 1u << s;
+    }
+
+    g->pluralities = tiedPluralities;
+}
+
+/**
+ * @brief Adds `delta` to the number of MPs of the suit of the card `i` in `parliamentSuitSizes`. Jokers aren't
+ * counted. `pluralities` has to be updated afterwards.
+ */
+static void parlGame_countMp(ParlGame* const g, const ParlIdx i, const int delta)
+{
+    if(!PARL_IS_JOKER(i))
+        g->parliamentSuitSizes[PARL_SUIT(i)] += delta;
+}
 
 bool parlGame_init(ParlGame* const g,
                    const int numJokers,
@@ -19,6 +116,10 @@ bool parlGame_init(ParlGame* const g,
                    const ParlPlayer myPosition,
                    const ParlIdx myFirstCardIdx)
 {
+    // The draw deck has to fit in `drawDeckSize`, which is the tighter limit when jokers are counted
+    if(numJokers < 0 || numJokers > PARL_MAX_JOKERS || PARL_NUM_NON_JOKER_CARDS + numJokers - numPlayers >= 64)
+        return false;
+
     *g = (ParlGame){
         .numPlayers = numPlayers,
         .myPosition = myPosition,
@@ -30,42 +131,30 @@ bool parlGame_init(ParlGame* const g,
         .discard = PARL_EMPTY_STACK,
         .drawDeckSize = PARL_NUM_NON_JOKER_CARDS + numJokers - numPlayers,
         .mode = NORMAL_MODE,
-        .elecCands = NULL,
 
-        .knownHands = calloc(numPlayers, sizeof(ParlStack)),
-        .faceDownCards = numJokers * PARL_JOKER_CARD
+        .faceDownCards = PARL_JOKERS(numJokers)
             + PARL_COMPLETE_STACK_NO_JOKERS
             - PARL_CARD(myFirstCardIdx),
     };
 
-    if(!g->knownHands)
-        return false;
     g->knownHands[g->myPosition] = PARL_CARD(myFirstCardIdx);
 
     PARL_FOREACH_PLAYER(g, p)
         g->handSizes[p] = 1;
 
+    parlGame_updatePluralities(g);
+    g->hash = parlZobrist_hash(g);
     return true;
 }
 
 void parlGame_free(const ParlGame* const g)
 {
-    free(g->knownHands);
-    if(g->mode == ELECTION_MODE)
-        free(g->elecCands);
+    (void)g;
 }
 
 bool parlGame_deepCopy(ParlGame* const dest, const ParlGame* const orig)
 {
-    const register unsigned int KNOWN_HANDS_SIZE = dest->numPlayers * sizeof(ParlStack);
-
-    memcpy(dest, orig, sizeof(ParlGame));
-
-    if(!(dest->knownHands = malloc(KNOWN_HANDS_SIZE)))
-        return false;
-
-    memcpy(dest->knownHands, orig->knownHands, KNOWN_HANDS_SIZE);
-
+    *dest = *orig;
     return true;
 }
 
@@ -75,24 +164,23 @@ unsigned int parlGame_legalActions(const ParlGame* const g)
     {
         case NORMAL_MODE:;
             register unsigned int legalMoves = 0u;
-            #define PARL_ADD_LEGAL_MOVE(m) legalMoves |= 1u<<m
+            #define PARL_ADD_LEGAL_MOVE(m) legalMoves |= 1u<<(m)
 
             const register int handSize = g->handSizes[g->turn];
-            const register int parlSize = parlStackSize(g->parliament);
-            const register bool myTurn = PARL_MY_TURN(g);
+            const register int parlSize = PARL_STACK_SIZE(g->parliament);
             const register bool iAmPm = g->turn == g->pmPosition;
-            const register ParlStack playerHand = g->knownHands[g->turn];
+            const register ParlStack playerHand = parlGame_possibleHand(g);
 
-            // PM-exclusive actions
-            if(iAmPm && parlStackSize(g->cabinet))
+            // PM-exclusive actions; jokers can't be moved into Cabinet, so a reshuffle needs an MP that isn't one
+            if(iAmPm && g->cabinet)
             {
                 PARL_ADD_LEGAL_MOVE(APPOINT_PM);
-                if(parlSize)
+                if(PARL_WITHOUT_JOKERS(g->parliament))
                     PARL_ADD_LEGAL_MOVE(CABINET_RESHUFFLE);
             }
 
             if(handSize <= PARL_MAX_CARDS_IN_HAND)
-                PARL_ADD_LEGAL_MOVE(g->turn == g->myPosition ? 1u<<SELF_DRAW : 1u<<DRAW);
+                PARL_ADD_LEGAL_MOVE(PARL_MY_TURN(g) && !g->allHandsKnown ? SELF_DRAW : DRAW);
 
             // All actions below here require a non-empty hand
             if(!handSize)
@@ -106,43 +194,33 @@ unsigned int parlGame_legalActions(const ParlGame* const g)
             if(handSize >= 3)
             {
                 register bool electionLegal = true;
-                register bool vncLegal = true;
+                register bool vncLegal;
 
                 PARL_FOREACH_SUIT(s)
-                    if (parlStackSize(PARL_FILTER_SUIT(playerHand + g->faceDownCards, s)) >= 3)
+                    if(PARL_POPCOUNT(PARL_FILTER_SUIT(playerHand, s)) >= 3)
                         goto electionLegal;
 
                 electionLegal = false;
                 electionLegal:;
 
-                register int numCards;
-                register bool matchesPluralitySuit;
-                register unsigned int pluralitySuits = parlGame_tiedPluralities(g);
-
-                PARL_FOREACH_RANK_FROM(r, 0)
+                // There has to be a PM to vote out
+                if(g->pmPosition == PARL_NO_PM)
+                    vncLegal = false;
+                else
                 {
-                    numCards = 0;
-                    matchesPluralitySuit = false;
+                    const register unsigned int pluralitySuits = parlGame_tiedPluralities(g);
+                    register uint64_t votingRanks = 0;
 
+                    // One of the cards must be of a tied plurality suit with no MPs of that suit at or above it
                     PARL_FOREACH_SUIT(s)
-                    {
-                        if(parlGame_handContains(g, PARL_RS_TO_CARD(r, s)))
-                            ++numCards;
-
-                        if(
-                            ((1u<<s) & pluralitySuits)
-                            && (PARL_FILTER_SUIT(g->parliament, s) >> PARL_RS_TO_IDX(r, s))
-                        )
-                            matchesPluralitySuit = true;
-                    }
+                        if((1u<<s) & pluralitySuits)
+                            votingRanks |=
+                                PARL_SUIT_RANKS(playerHand, s) & ~parlRanksUpToHighest(PARL_SUIT_RANKS(g->parliament, s));
 
-                    if(numCards >= 3 && matchesPluralitySuit)
-                        goto vncLegal;
+                    // ...and there must be at least three cards of its rank
+                    vncLegal = votingRanks & PARL_RANKS_IN_THREE_SUITS(playerHand);
                 }
 
-                vncLegal = false;
-                vncLegal:;
-
                 if(electionLegal) PARL_ADD_LEGAL_MOVE(CALL_ELECTION);
                 if(vncLegal) PARL_ADD_LEGAL_MOVE(VOTE_NO_CONF);
             }
@@ -151,38 +229,30 @@ unsigned int parlGame_legalActions(const ParlGame* const g)
             {
                 const register ParlRank pmCardRank = PARL_RANK(g->pmCardIdx);
 
-                // Kings can impeach kings
-                if(pmCardRank == PARL_KING_RANK)
-                {
-                    PARL_FOREACH_SUIT(s)
-                        if(parlGame_handContains(g, PARL_RS_TO_CARD(PARL_KING_RANK, s)))
-                            goto impeachPmLegal;
-                }
-                else
-                {
-                    PARL_FOREACH_RANK_FROM(r, pmCardRank + 1)
-                        PARL_FOREACH_SUIT(s)
-                            if(parlGame_handContains(g, PARL_RS_TO_CARD(r, s)))
-                                goto impeachPmLegal;
-                }
+                // Every card that `parlGame_handContains` would accept, which can be more than `playerHand`
+                const register ParlStack containable = PARL_KNOWS_HAND(g, g->turn)
+                    ? g->knownHands[g->turn]
+                    : g->knownHands[g->turn] | g->faceDownCards;
 
-                goto impeachPmIllegal;
+                // Kings can impeach kings
+                const register uint64_t beatsPm = pmCardRank == PARL_KING_RANK
+                    ? 1ull << PARL_KING_RANK
+                    : PARL_RANKS_ABOVE(pmCardRank);
 
-                impeachPmLegal: PARL_ADD_LEGAL_MOVE(IMPEACH_PM);
-                impeachPmIllegal:;
+                if(PARL_RANKS_IN(containable) & beatsPm)
+                    PARL_ADD_LEGAL_MOVE(IMPEACH_PM);
             }
 
             if(handSize > 0 && parlSize)
             {
-                PARL_FOREACH_IN_STACK(g->parliament, mp)
-                    PARL_FOREACH_IN_STACK(playerHand + g->faceDownCards, h)
-                        if(PARL_HIGHER_THAN(h, mp))
-                            goto impeachMpLegal;
-                goto impeachMpIllegal;
-
-                impeachMpLegal:
-                PARL_ADD_LEGAL_MOVE(IMPEACH_MP);
-                impeachMpIllegal:;
+                const register uint64_t mpRanks = PARL_RANKS_IN(g->parliament);
+
+                // Jokers outrank every MP, and otherwise a card has to outrank the lowest MP
+                if(
+                    mpRanks
+                    && (PARL_NUM_JOKERS(playerHand) || PARL_RANKS_IN(playerHand) & PARL_RANKS_ABOVE(PARL_LOWEST_IDX(mpRanks)))
+                )
+                    PARL_ADD_LEGAL_MOVE(IMPEACH_MP);
             }
 
             return legalMoves;
@@ -195,7 +265,7 @@ unsigned int parlGame_legalActions(const ParlGame* const g)
         case ELECTION_MODE:
             return (1u<<CONTEST_ELECTION) | (1u<<NO_CONTEST_ELECTION);
         case BACKUP_PM_MODE:
-            return 1u<<APPOINT_PM;
+            return 1u<<APPOINT_BACKUP_PM;
         case ENDGAME_MODE:
             return (1u<<ENDGAME_TRY_FORMATION) | (1u<<ENDGAME_PASS_FORMATION);
         case PM_CHOOSE_FIRST_LAST_MODE:
@@ -209,78 +279,374 @@ unsigned int parlGame_legalActions(const ParlGame* const g)
     }
 }
 
-unsigned int parlGame_tiedPluralities(const ParlGame* const g)
+int parlGame_generateMoves(const ParlGame* const g, ParlMove* const out, const int cap)
 {
-    register unsigned int tiedPluralities = 0;
-    register int pluralitySuitSize = 0, thisSuitSize;
+    register int numMoves = 0;
+    const register unsigned int legal = parlGame_legalActions(g);
+    const register ParlStack hand = parlGame_possibleHand(g);
+    const register ParlStack known = g->knownHands[g->turn];
+
+    // The number of cards in the hand of the player whose turn it is that we haven't seen
+    const register int numHidden = PARL_KNOWS_HAND(g, g->turn) ? 0 : g->handSizes[g->turn] - PARL_STACK_SIZE(known);
+
+    #define PARL_CAN_PLAY(s) (PARL_POPCOUNT(PARL_WITHOUT_JOKERS(s) & ~known) <= numHidden)
+    #define PARL_LEGAL(a) (legal & (1u<<(a)))
+    #define PARL_ADD_MOVE(a, iA, iB, iC) do { \
+        if(numMoves < cap) \
+            out[numMoves] = (ParlMove){ .action = (a), .idxA = (iA), .idxB = (iB), .idxC = (iC) }; \
+        ++numMoves; \
+    } while(0)
+    #define PARL_ADD_MOVE_0(a) PARL_ADD_MOVE(a, PARL_NO_ARG, PARL_NO_ARG, PARL_NO_ARG)
+    #define PARL_ADD_MOVE_1(a, iA) PARL_ADD_MOVE(a, iA, PARL_NO_ARG, PARL_NO_ARG)
 
-    PARL_FOREACH_SUIT(s)
+    switch(g->mode)
     {
-        thisSuitSize = parlStackSize(PARL_FILTER_SUIT(g->parliament, s));
-        if(thisSuitSize > pluralitySuitSize)
-        {
-            pluralitySuitSize = thisSuitSize;
-            tiedPluralities = 1u << s;
-        }
-        else if(thisSuitSize == pluralitySuitSize)
-            tiedPluralities |= 1u << s;
+        case NORMAL_MODE:
+            if(PARL_LEGAL(DRAW))
+                PARL_ADD_MOVE_0(DRAW);
+
+            // Which card the known player gets is up to chance, so list them all
+            if(PARL_LEGAL(SELF_DRAW))
+                PARL_FOREACH_KIND_IN_STACK(g->faceDownCards, i)
+                    PARL_ADD_MOVE_1(SELF_DRAW, i);
+
+            if(PARL_LEGAL(APPOINT_PM))
+                PARL_FOREACH_KIND_IN_STACK(g->cabinet, i)
+                    PARL_ADD_MOVE_1(APPOINT_PM, i);
+
+            // Jokers can't be moved into Cabinet since they have no suit
+            if(PARL_LEGAL(CABINET_RESHUFFLE))
+                PARL_FOREACH_KIND_IN_STACK(g->cabinet, i)
+                    PARL_FOREACH_IN_STACK(g->parliament, mp)
+                        PARL_ADD_MOVE(CABINET_RESHUFFLE, i, mp, PARL_NO_ARG);
+
+            if(PARL_LEGAL(DISCARD))
+                PARL_FOREACH_KIND_IN_STACK(hand, i)
+                    PARL_ADD_MOVE_1(DISCARD, i);
+
+            if(PARL_LEGAL(APPOINT_MP))
+                PARL_FOREACH_KIND_IN_STACK(hand, i)
+                    PARL_ADD_MOVE_1(APPOINT_MP, i);
+
+            if(PARL_LEGAL(CALL_ELECTION))
+                PARL_FOREACH_SUIT(s)
+                {
+                    const register ParlStack suitCards = PARL_FILTER_SUIT(hand, s);
+
+                    // Any card can be the PM candidate; the two calling cards are unordered
+                    PARL_FOREACH_IN_STACK(suitCards, pm)
+                    {
+                        const register ParlStack callingCards = suitCards & ~PARL_CARD(pm);
+
+                        PARL_FOREACH_IN_STACK(callingCards, b)
+                            PARL_FOREACH_IN_STACK(callingCards & (~PARL_EMPTY_STACK << b << 1), c)
+                                if(PARL_CAN_PLAY(PARL_CARD(pm) | PARL_CARD(b) | PARL_CARD(c)))
+                                    PARL_ADD_MOVE(CALL_ELECTION, pm, b, c);
+                    }
+                }
+
+            // Outranking is decided per rank, so these need the hand in rank-major order
+            const register ParlRankStack handByRank =
+                legal & ((1u<<IMPEACH_MP) | (1u<<IMPEACH_PM)) ? parlToRankMajor(hand) : PARL_EMPTY_STACK;
+
+            // Jokers outrank every MP
+            if(PARL_LEGAL(IMPEACH_MP))
+                PARL_FOREACH_IN_STACK(g->parliament, mp)
+                {
+                    const register ParlStack higher =
+                        parlFromRankMajor(handByRank & PARL_RANK_MAJOR_ABOVE(PARL_RANK(mp)))
+                        | (hand ^ PARL_WITHOUT_JOKERS(hand));
+
+                    PARL_FOREACH_KIND_IN_STACK(higher, h)
+                        PARL_ADD_MOVE(IMPEACH_MP, mp, h, PARL_NO_ARG);
+                }
+
+            if(PARL_LEGAL(IMPEACH_PM))
+            {
+                const register ParlRank pmCardRank = PARL_RANK(g->pmCardIdx);
+
+                // Kings can impeach kings
+                const register ParlStack higher = parlFromRankMajor(handByRank & PARL_RANK_MAJOR_ABOVE(
+                    pmCardRank == PARL_KING_RANK ? PARL_KING_RANK - 1 : pmCardRank
+                ));
+
+                PARL_FOREACH_IN_STACK(higher, i)
+                    PARL_ADD_MOVE_1(IMPEACH_PM, i);
+            }
+
+            if(PARL_LEGAL(VOTE_NO_CONF))
+            {
+                const register unsigned int pluralitySuits = parlGame_tiedPluralities(g);
+
+                // Only ranks with at least three cards in the hand can be played
+                const register uint64_t triples = parlGatherRanks(PARL_RANK_MAJOR_TRIPLES(parlToRankMajor(hand)));
+
+                PARL_FOREACH_IN_STACK(triples, r)
+                {
+                    const register ParlStack rankCards = PARL_FILTER_RANK(hand, r);
+
+                    // Cards that can be the one of the tied plurality suit that the MPs are checked against
+                    register ParlStack selectable = PARL_EMPTY_STACK;
+                    PARL_FOREACH_SUIT(s)
+                        if(
+                            ((1u<<s) & pluralitySuits)
+                            && !(PARL_FILTER_SUIT(g->parliament, s) >> PARL_RS_TO_IDX(r, s))
+                        )
+                            selectable |= PARL_RS_TO_CARD(r, s);
+
+                    // Each 3-card subset leaves out one of the 4 cards, or none of them if there are only 3
+                    PARL_FOREACH_SUIT(omitted)
+                    {
+                        register ParlStack played = rankCards & ~PARL_RS_TO_CARD(r, omitted);
+                        if(PARL_POPCOUNT(played) != 3 || !(played & selectable) || !PARL_CAN_PLAY(played))
+                            continue;
+
+                        // The selected card goes first since that's the one parlGame_applyAction checks
+                        const register ParlIdx selected = PARL_LOWEST_IDX(played & selectable);
+                        played &= ~PARL_CARD(selected);
+                        PARL_ADD_MOVE(
+                            VOTE_NO_CONF,
+                            selected,
+                            PARL_LOWEST_IDX(played),
+                            PARL_LOWEST_IDX(played & (played - 1))
+                        );
+                    }
+                }
+            }
+
+            break;
+
+        case DISCARD_AFTER_DRAW_MODE:
+            PARL_FOREACH_KIND_IN_STACK(hand, i)
+                PARL_ADD_MOVE_1(DISCARD, i);
+            break;
+
+        case REIMPEACH_MODE:
+        case BLOCK_IMPEACH_MODE:;
+            const register ParlAction blockAction = g->mode == REIMPEACH_MODE ? REIMPEACH : BLOCK_IMPEACH;
+
+            // Aces beat jokers
+            if(PARL_IS_JOKER(g->cardToBeatIdx))
+            {
+                const register ParlIdx ace = PARL_RS_TO_IDX(PARL_ACE_RANK, PARL_SUIT(g->impeachedMpIdx));
+                if(hand & PARL_CARD(ace))
+                    PARL_ADD_MOVE_1(blockAction, ace);
+            }
+            else PARL_FOREACH_IN_STACK(PARL_FILTER_SUIT(hand, PARL_SUIT(g->impeachedMpIdx)), i)
+                if(PARL_HIGHER_THAN(i, g->cardToBeatIdx))
+                    PARL_ADD_MOVE_1(blockAction, i);
+
+            PARL_ADD_MOVE_0(g->mode == REIMPEACH_MODE ? NO_REIMPEACH : NO_BLOCK_IMPEACH);
+            break;
+
+        case ELECTION_MODE:
+            PARL_FOREACH_SUIT(s)
+            {
+                const register ParlStack suitCards = PARL_FILTER_SUIT(hand, s);
+
+                PARL_FOREACH_IN_STACK(suitCards, pm)
+                    PARL_FOREACH_IN_STACK(suitCards & ~PARL_CARD(pm), b)
+                        if(PARL_CAN_PLAY(PARL_CARD(pm) | PARL_CARD(b)))
+                            PARL_ADD_MOVE(CONTEST_ELECTION, pm, b, PARL_NO_ARG);
+            }
+
+            PARL_ADD_MOVE_0(NO_CONTEST_ELECTION);
+            break;
+
+        case BACKUP_PM_MODE:
+            PARL_FOREACH_KIND_IN_STACK(g->cabinet, i)
+                PARL_ADD_MOVE_1(APPOINT_BACKUP_PM, i);
+            break;
+
+        case ENDGAME_MODE:
+            if(g->turn == g->pmPosition)
+                PARL_ADD_MOVE_0(ENDGAME_TRY_FORMATION);
+            else PARL_FOREACH_IN_STACK(hand, i)
+                PARL_ADD_MOVE_1(ENDGAME_TRY_FORMATION, i);
+
+            PARL_ADD_MOVE_0(ENDGAME_PASS_FORMATION);
+            break;
+
+        case PM_CHOOSE_FIRST_LAST_MODE:
+            PARL_ADD_MOVE_0(ENDGAME_PM_FIRST);
+            PARL_ADD_MOVE_0(ENDGAME_PM_LAST);
+            break;
+
+        case BLOCK_COALITION_MODE:
+        case COUNTER_BLOCK_COALITION_MODE:;
+            const register bool counter = g->mode == COUNTER_BLOCK_COALITION_MODE;
+
+            PARL_FOREACH_IN_STACK(PARL_FILTER_SUIT(hand, PARL_SUIT(g->cardToBeatIdx)), i)
+                if(PARL_HIGHER_THAN(i, g->cardToBeatIdx))
+                    PARL_ADD_MOVE_1(counter ? ENDGAME_COUNTER_BLOCK_COALITION : ENDGAME_BLOCK_COALITION, i);
+
+            PARL_ADD_MOVE_0(counter ? ENDGAME_NO_COUNTER_BLOCK_COALITION : ENDGAME_NO_BLOCK_COALITION);
+            break;
+
+        case GAME_OVER:
+            break;
     }
 
-    return tiedPluralities;
+    return numMoves;
 }
 
-ParlSuit parlGame_plurality(const ParlGame* g)
+bool parlGame_applyMove(ParlGame* const g, const ParlMove m)
 {
-    register ParlSuit plurality = INVALID_SUIT;
-    register int pluralitySuitSize = 0, thisSuitSize;
+    return parlGame_applyAction(g, m.action, m.idxA, m.idxB, m.idxC);
+}
 
-    PARL_FOREACH_SUIT(s)
+bool parlGame_applyActionUndoable(ParlGame* const g,
+                                  ParlUndo* const u,
+                                  const ParlAction a,
+                                  const ParlIdx idxA,
+                                  const ParlIdx idxB,
+                                  const ParlIdx idxC)
+{
+    register unsigned int players = g->mode == ELECTION_MODE ? (1u << g->numPlayers) - 1 : 1u << g->turn;
+
+    if(g->pmPosition != PARL_NO_PM)
+        players |= 1u << g->pmPosition;
+
+    u->hash = g->hash;
+    u->cabinet = g->cabinet;
+    u->parliament = g->parliament;
+    u->discard = g->discard;
+    u->faceDownCards = g->faceDownCards;
+    u->turn = g->turn;
+    u->pmPosition = g->pmPosition;
+    u->pmCardIdx = g->pmCardIdx;
+    u->drawDeckSize = g->drawDeckSize;
+    u->mode = g->mode;
+    u->coalitionSize = g->coalitionSize;
+    u->endgameSkipPm = g->endgameSkipPm;
+    u->currNormalTurn = g->currNormalTurn;
+    u->cardToBeatIdx = g->cardToBeatIdx;
+    u->impeachedMpIdx = g->impeachedMpIdx;
+    u->cycleStarter = g->cycleStarter;
+    memcpy(u->parliamentSuitSizes, g->parliamentSuitSizes, sizeof u->parliamentSuitSizes);
+    u->pluralities = g->pluralities;
+    u->numPlayers = 0;
+
+    for(; players; players &= players - 1)
     {
-        thisSuitSize = parlStackSize(PARL_FILTER_SUIT(g->parliament, s));
+        const register ParlPlayer p = PARL_LOWEST_IDX(players);
+
+        u->players[u->numPlayers++] = (struct ParlUndoPlayer){
+            .p = p,
+            .handSize = g->handSizes[p],
+            .elecCand = g->elecCands[p],
+            .knownHand = g->knownHands[p]
+        };
+    }
 
-        if(!thisSuitSize)
-            continue;
+    if(parlGame_applyAction(g, a, idxA, idxB, idxC))
+        return true;
 
-        if(thisSuitSize > pluralitySuitSize)
-        {
-            plurality = s;
-            pluralitySuitSize = thisSuitSize;
-        }
-        else if(thisSuitSize == pluralitySuitSize)
-            return INVALID_SUIT;
+    // Illegal actions may have changed some of the state before failing
+    parlGame_undoAction(g, u);
+    return false;
+}
+
+bool parlGame_applyMoveUndoable(ParlGame* const g, ParlUndo* const u, const ParlMove m)
+{
+    return parlGame_applyActionUndoable(g, u, m.action, m.idxA, m.idxB, m.idxC);
+}
+
+void parlGame_undoAction(ParlGame* const g, const ParlUndo* const u)
+{
+    g->hash = u->hash;
+    g->cabinet = u->cabinet;
+    g->parliament = u->parliament;
+    g->discard = u->discard;
+    g->faceDownCards = u->faceDownCards;
+    g->turn = u->turn;
+    g->pmPosition = u->pmPosition;
+    g->pmCardIdx = u->pmCardIdx;
+    g->drawDeckSize = u->drawDeckSize;
+    g->mode = u->mode;
+    g->coalitionSize = u->coalitionSize;
+    g->endgameSkipPm = u->endgameSkipPm;
+    g->currNormalTurn = u->currNormalTurn;
+    g->cardToBeatIdx = u->cardToBeatIdx;
+    g->impeachedMpIdx = u->impeachedMpIdx;
+    g->cycleStarter = u->cycleStarter;
+    memcpy(g->parliamentSuitSizes, u->parliamentSuitSizes, sizeof g->parliamentSuitSizes);
+    g->pluralities = u->pluralities;
+
+    for(register int i = 0; i < u->numPlayers; ++i)
+    {
+        const register ParlPlayer p = u->players[i].p;
+
+        g->handSizes[p] = u->players[i].handSize;
+        g->elecCands[p] = u->players[i].elecCand;
+        g->knownHands[p] = u->players[i].knownHand;
     }
+}
+
+ParlStack parlGame_possibleHand(const ParlGame* const g)
+{
+    const register ParlStack known = g->knownHands[g->turn];
 
-    return plurality;
+    // Only a player with cards we haven't seen can be holding face-down cards
+    register ParlStack possible =
+        PARL_KNOWS_HAND(g, g->turn) || g->handSizes[g->turn] <= PARL_STACK_SIZE(known) ? known : known + g->faceDownCards;
+
+    // Cards that other election candidates have already played can't be in this hand
+    if(g->mode == ELECTION_MODE)
+        PARL_FOREACH_PLAYER(g, p)
+            if(p != g->turn)
+                possible &= ~g->elecCands[p].callingCards;
+
+    return possible;
+}
+
+unsigned int parlGame_tiedPluralities(const ParlGame* const g)
+{
+    return g->pluralities;
+}
+
+ParlSuit parlGame_plurality(const ParlGame* const g)
+{
+    // Either a single suit has the most MPs, or several are tied, which includes when Parliament is empty
+    return g->pluralities & (g->pluralities - 1) ? INVALID_SUIT : (ParlSuit)PARL_LOWEST_IDX(g->pluralities);
 }
 
 bool parlGame_applyAction(ParlGame* const g,
                           const ParlAction a,
-                          const ParlIdx idxA,
-                          const ParlIdx idxB,
-                          const ParlIdx idxC
-                          )
+                          ParlIdx idxA,
+                          ParlIdx idxB,
+                          ParlIdx idxC)
 {
     // TODO Sanity check: idxA, idxB, and idxC must all be diff cards unless they're PARL_NO_ARG
 
-    register ParlStack cardA = PARL_CARD(idxA),
-        cardB = PARL_CARD(idxB),
-        cardC = PARL_CARD(idxC);
+    // A joker argument can be any joker, so take the one the player would give up: a drawn joker comes from the
+    // face-down cards, and any other joker from their known hand first, like in `parlGame_removeFromHandOf`
+    const register ParlStack jokerSource = a == SELF_DRAW || !PARL_NUM_JOKERS(g->knownHands[g->turn])
+        ? g->faceDownCards
+        : g->knownHands[g->turn];
+
+    idxA = parlMatchJoker(idxA, jokerSource);
+    idxB = parlMatchJoker(idxB, jokerSource);
+    idxC = parlMatchJoker(idxC, jokerSource);
+
+    register ParlStack cardA = PARL_ARG_CARD(idxA),
+        cardB = PARL_ARG_CARD(idxB),
+        cardC = PARL_ARG_CARD(idxC);
 
     switch(a)
     {
         case SELF_DRAW:
-            if(!parlMoveCards(
-                &(g->knownHands[g->turn]),
-                &g->faceDownCards,
-                cardA
-            ))
+            if(!PARL_CONTAINS(g->faceDownCards, cardA))
                 return false;
+
+            PARL_SET_STACK(PARL_ZOBRIST_FACE_DOWN, faceDownCards, g->faceDownCards - cardA);
+            PARL_SET_STACK_OF(PARL_ZOBRIST_KNOWN_HAND, g->turn, knownHands[g->turn], g->knownHands[g->turn] + cardA);
         case DRAW:
             DECREASE_HAND_SIZE(-1);
-            --g->drawDeckSize;
+            PARL_SET(PARL_ZOBRIST_DRAW_DECK_SIZE, drawDeckSize, g->drawDeckSize - 1);
 
             if(g->handSizes[g->turn] > PARL_MAX_CARDS_IN_HAND)
-                g->mode = DISCARD_AFTER_DRAW_MODE;
+                PARL_SET(PARL_ZOBRIST_MODE, mode, DISCARD_AFTER_DRAW_MODE);
             else if(g->drawDeckSize == 0)
                 parlGame_moveToEndgame(g);
             else
@@ -288,29 +654,27 @@ bool parlGame_applyAction(ParlGame* const g,
             return true;
 
         case IMPEACH_PM:
-            g->discard += PARL_CARD(g->pmCardIdx);
+            if(!parlGame_handContains(g, cardA))
+                return false;
 
-            switch(parlStackSize(g->cabinet))
+            PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard + PARL_CARD(g->pmCardIdx));
+
+            switch(PARL_STACK_SIZE(g->cabinet))
             {
                 // No more PM!
                 case 0:
-                    g->pmPosition = PARL_NO_PM;
-                    g->pmCardIdx = PARL_NO_PM;
+                    PARL_SET(PARL_ZOBRIST_PM_POSITION, pmPosition, PARL_NO_PM);
+                    PARL_SET(PARL_ZOBRIST_PM_CARD, pmCardIdx, PARL_NO_PM);
                     break;
                 // There is only one card that the PM card can be replaced with, so the PM doesn't get a choice
                 case 1:
-                    PARL_FOREACH_IDX(i)
-                        // We know this must be the only card in Cabinet since we also know its size is 1
-                        if(PARL_CONTAINS(g->cabinet, PARL_CARD(i)))
-                        {
-                            g->pmCardIdx = i;
-                            break;
-                        }
+                    // We know this must be the only card in Cabinet since we also know its size is 1
+                    PARL_SET(PARL_ZOBRIST_PM_CARD, pmCardIdx, PARL_LOWEST_IDX(g->cabinet));
                     // After removing the only card in Cabinet, it must be empty
-                    g->cabinet = PARL_EMPTY_STACK;
+                    PARL_SET_STACK(PARL_ZOBRIST_CABINET, cabinet, PARL_EMPTY_STACK);
                     break;
                 default:
-                    g->mode = BACKUP_PM_MODE;
+                    PARL_SET(PARL_ZOBRIST_MODE, mode, BACKUP_PM_MODE);
                     parlGame_saveNormalTurn(g);
                     break;
             }
@@ -325,7 +689,7 @@ bool parlGame_applyAction(ParlGame* const g,
                 // This means we came from IMPEACH_PM, not from DISCARD, and the move after this one is the PM's
                 // replacement of the PM card.
                 case BACKUP_PM_MODE:
-                    g->turn = g->pmPosition;
+                    PARL_SET(PARL_ZOBRIST_TURN, turn, g->pmPosition);
                     return true;
 
                 case DISCARD_AFTER_DRAW_MODE:
@@ -335,7 +699,7 @@ bool parlGame_applyAction(ParlGame* const g,
                         return true;
                     }
 
-                    g->mode = NORMAL_MODE;
+                    PARL_SET(PARL_ZOBRIST_MODE, mode, NORMAL_MODE);
                     // Fallthrough to default
                 default:
                     parlGame_incTurn(g);
@@ -346,6 +710,8 @@ bool parlGame_applyAction(ParlGame* const g,
             if(!parlGame_moveFromHandTo(g, &g->parliament, cardA))
                 return false;
 
+            parlGame_countMp(g, idxA, 1);
+            parlGame_updatePluralities(g);
             parlGame_incTurn(g);
             return true;
 
@@ -368,20 +734,19 @@ bool parlGame_applyAction(ParlGame* const g,
                 cardBFromHand = cardBOrigin == FROM_HAND,
                 cardCFromHand = cardCOrigin == FROM_HAND;
 
-            g->elecCands = malloc(g->numPlayers * sizeof(struct ParlElectionCand));
-            g->elecCands[g->turn] = (struct ParlElectionCand){
-                .pmIdx = idxA,
-                .callingCards = cardA | cardB | cardC,
-                .preCallNumCards = g->handSizes[g->turn]
-            };
+            PARL_SET_OF(PARL_ZOBRIST_CAND_PM, g->turn, elecCands[g->turn].pmIdx, idxA);
+            PARL_SET_STACK_OF(PARL_ZOBRIST_CALLING_CARDS, g->turn, elecCands[g->turn].callingCards,
+                              cardA | cardB | cardC);
+            PARL_SET_OF(PARL_ZOBRIST_CAND_PRE_CALL_NUM_CARDS, g->turn, elecCands[g->turn].preCallNumCards,
+                        g->handSizes[g->turn]);
 
             // The hand size will decrease regardless of where the cards go
             DECREASE_HAND_SIZE(cardAFromHand + cardBFromHand + cardCFromHand);
 
-            g->mode = ELECTION_MODE;
-            g->cycleStarter = g->turn;
+            PARL_SET(PARL_ZOBRIST_MODE, mode, ELECTION_MODE);
+            PARL_SET(PARL_ZOBRIST_CYCLE_STARTER, cycleStarter, g->turn);
             parlGame_saveNormalTurn(g);
-            g->turn = g->cycleStarter == 0 ? 1 : 0;
+            PARL_SET(PARL_ZOBRIST_TURN, turn, g->cycleStarter == 0 ? 1 : 0);
             return true;
 
         case IMPEACH_MP:
@@ -392,18 +757,15 @@ bool parlGame_applyAction(ParlGame* const g,
             )
                 return false;
 
-            g->impeachedMpIdx = idxA;
-            g->cardToBeatIdx = idxB;
+            PARL_SET(PARL_ZOBRIST_IMPEACHED_MP, impeachedMpIdx, idxA);
+            PARL_SET(PARL_ZOBRIST_CARD_TO_BEAT, cardToBeatIdx, idxB);
 
-            g->mode = BLOCK_IMPEACH_MODE;
+            PARL_SET(PARL_ZOBRIST_MODE, mode, BLOCK_IMPEACH_MODE);
             parlGame_saveNormalTurn(g);
-            g->turn = 0;
+            PARL_SET(PARL_ZOBRIST_TURN, turn, 0);
             return true;
 
         case VOTE_NO_CONF:;
-            if(!parlGame_removeFromHand(g, cardA + cardB + cardC))
-                return false;
-
             ParlSuit rankA = PARL_RANK(idxA),
                 rankB = PARL_RANK(idxB),
                 rankC = PARL_RANK(idxC);
@@ -422,41 +784,35 @@ bool parlGame_applyAction(ParlGame* const g,
                 selectedIdx = idxC;
             else return false;
 
-            register ParlSuit selectedSuit = PARL_SUIT(selectedIdx);
-
-            for(
-                ParlIdx i = PARL_RS_TO_IDX(PARL_KING_RANK, selectedSuit);
-                i >= PARL_RS_TO_IDX(PARL_ACE_RANK, selectedSuit);
-                --i
+            // If there are any MPs of the selected plurality suit at or above the calling card, the calling cards
+            // aren't high enough
+            if(
+                PARL_FILTER_SUIT(g->parliament, PARL_SUIT(selectedIdx)) >> selectedIdx
+                || !parlGame_removeFromHand(g, cardA + cardB + cardC)
             )
-            {
-                // Iterate through all cards of the selected plurality suit going down.
-                // If we hit the calling card before hitting any MPs it means there are no MPs higher than that card.
-                if(PARL_CONTAINS(g->parliament, PARL_CARD(i)))
-                    // Illegal -- calling cards aren't high enough
-                    return false;
-
-                if(i == selectedIdx)
-                    // Legal
-                    break;
-            }
+                return false;
 
-            g->discard |= PARL_CARD(g->pmCardIdx) | g->cabinet;
-            g->pmPosition = PARL_NO_PM;
-            g->pmCardIdx = PARL_NO_PM;
-            g->cabinet = PARL_EMPTY_STACK;
+            PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard,
+                           g->discard | cardA | cardB | cardC | PARL_CARD(g->pmCardIdx) | g->cabinet);
+            PARL_SET(PARL_ZOBRIST_PM_POSITION, pmPosition, PARL_NO_PM);
+            PARL_SET(PARL_ZOBRIST_PM_CARD, pmCardIdx, PARL_NO_PM);
+            PARL_SET_STACK(PARL_ZOBRIST_CABINET, cabinet, PARL_EMPTY_STACK);
 
             parlGame_incTurn(g);
             return true;
 
         case CABINET_RESHUFFLE:
-            if(!PARL_CONTAINS(g->cabinet, cardA) || !PARL_CONTAINS(g->parliament, cardB))
+            if(!PARL_CONTAINS(g->cabinet, cardA) || PARL_IS_JOKER(idxB) || !PARL_CONTAINS(g->parliament, cardB))
                 return false;
 
             // "Move to Cabinet from Parliament card B"
-            parlMoveCards(&g->cabinet, &g->parliament, cardB);
+            parlGame_moveCards(g, &g->cabinet, &g->parliament, cardB);
             // "Move to Parliament from Cabinet card A"
-            parlMoveCards(&g->parliament, &g->cabinet, cardA);
+            parlGame_moveCards(g, &g->parliament, &g->cabinet, cardA);
+
+            parlGame_countMp(g, idxB, -1);
+            parlGame_countMp(g, idxA, 1);
+            parlGame_updatePluralities(g);
 
             parlGame_incTurn(g);
             return true;
@@ -465,8 +821,8 @@ bool parlGame_applyAction(ParlGame* const g,
             if(!PARL_CONTAINS(g->cabinet, cardA))
                 return false;
 
-            g->cabinet |= PARL_CARD(g->pmCardIdx);
-            g->pmCardIdx = idxA;
+            PARL_SET_STACK(PARL_ZOBRIST_CABINET, cabinet, (g->cabinet & ~cardA) | PARL_CARD(g->pmCardIdx));
+            PARL_SET(PARL_ZOBRIST_PM_CARD, pmCardIdx, idxA);
             parlGame_incTurn(g);
             return true;
 
@@ -479,14 +835,14 @@ bool parlGame_applyAction(ParlGame* const g,
 
             if(PARL_HIGHER_THAN(idxA, g->cardToBeatIdx))
             {
-                g->discard |= PARL_CARD(g->cardToBeatIdx);
+                PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard | PARL_CARD(g->cardToBeatIdx));
                 parlGame_removeFromHand(g, cardA);
-                g->cardToBeatIdx = idxA;
-                g->turn = 0;
-                g->mode = REIMPEACH_MODE;
+                PARL_SET(PARL_ZOBRIST_CARD_TO_BEAT, cardToBeatIdx, idxA);
+                PARL_SET(PARL_ZOBRIST_TURN, turn, 0);
+                PARL_SET(PARL_ZOBRIST_MODE, mode, REIMPEACH_MODE);
             }
             else if(
-                g->cardToBeatIdx == PARL_JOKER_IDX
+                PARL_IS_JOKER(g->cardToBeatIdx)
                 && PARL_RANK(idxA) == PARL_ACE_RANK
             )
             {
@@ -505,14 +861,14 @@ bool parlGame_applyAction(ParlGame* const g,
 
             if(PARL_HIGHER_THAN(idxA, g->cardToBeatIdx))
             {
-                g->discard |= PARL_CARD(g->cardToBeatIdx);
+                PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard | PARL_CARD(g->cardToBeatIdx));
                 parlGame_removeFromHand(g, cardA);
-                g->cardToBeatIdx = idxA;
-                g->turn = 0;
-                g->mode = REIMPEACH_MODE;
+                PARL_SET(PARL_ZOBRIST_CARD_TO_BEAT, cardToBeatIdx, idxA);
+                PARL_SET(PARL_ZOBRIST_TURN, turn, 0);
+                PARL_SET(PARL_ZOBRIST_MODE, mode, REIMPEACH_MODE);
             }
             else if(
-                g->cardToBeatIdx == PARL_JOKER_IDX
+                PARL_IS_JOKER(g->cardToBeatIdx)
                 && PARL_RANK(idxA) == PARL_ACE_RANK
                 )
             {
@@ -532,42 +888,44 @@ bool parlGame_applyAction(ParlGame* const g,
             return true;
 
         case CONTEST_ELECTION:
-            if(!parlGame_handContains(g, cardA | cardB))
+            // The PM candidate and the calling card must be two different cards of the same suit
+            if(
+                idxA == idxB
+                || PARL_SUIT(idxA) != PARL_SUIT(idxB)
+                || !parlGame_handContains(g, cardA | cardB)
+            )
                 return false;
 
-            g->elecCands[g->turn] = (struct ParlElectionCand){
-                .pmIdx = idxA,
-                .callingCards = cardA | cardB,
-                .preCallNumCards = g->handSizes[g->turn]
-            };
+            PARL_SET_OF(PARL_ZOBRIST_CAND_PM, g->turn, elecCands[g->turn].pmIdx, idxA);
+            PARL_SET_STACK_OF(PARL_ZOBRIST_CALLING_CARDS, g->turn, elecCands[g->turn].callingCards, cardA | cardB);
+            PARL_SET_OF(PARL_ZOBRIST_CAND_PRE_CALL_NUM_CARDS, g->turn, elecCands[g->turn].preCallNumCards,
+                        g->handSizes[g->turn]);
 
             DECREASE_HAND_SIZE(2);
 
             goto contestElection;
 
         case NO_CONTEST_ELECTION:
-            g->elecCands[g->turn].callingCards = PARL_EMPTY_STACK;
+            PARL_SET_STACK_OF(PARL_ZOBRIST_CALLING_CARDS, g->turn, elecCands[g->turn].callingCards, PARL_EMPTY_STACK);
         contestElection:
 
+            // If the next player is the election caller, skip them
+            register ParlPlayer nextCand = g->turn + 1 == g->cycleStarter ? g->turn + 2 : g->turn + 1;
+
             // If not the last player
-            if(g->turn < g->numPlayers - 1)
+            if(nextCand < g->numPlayers)
             {
-                // If the next player is the election caller, skip them
-                if(g->turn + 1 == g->cycleStarter)
-                    ++g->turn;
-
-                parlGame_incTurn(g);
+                PARL_SET(PARL_ZOBRIST_TURN, turn, nextCand);
                 return true;
             }
 
             /* Last player, so no more candidates. Election is over */
 
-            /* Step 1: Find winners */
+            /* Step 1: Find the candidates and the winners among them in one pass */
 
-            register unsigned int winners = 0u;
-            register int numWinners = 0;
+            register unsigned int running = 0u, winners = 0u;
             register ParlRank highestRank = PARL_ACE_RANK;
-            register ParlRank thisRank;
+            register ParlPlayer winner = -1;
 
             PARL_FOREACH_PLAYER(g, p)
             {
@@ -575,164 +933,144 @@ bool parlGame_applyAction(ParlGame* const g,
                 if(g->elecCands[p].callingCards == PARL_EMPTY_STACK)
                     continue;
 
-                thisRank = PARL_RANK(g->elecCands[p].pmIdx);
+                running |= 1u << p;
+
+                const register ParlRank thisRank = PARL_RANK(g->elecCands[p].pmIdx);
                 if(thisRank > highestRank)
                 {
                     highestRank = thisRank;
-                    winners = 1u<<p;
-                    numWinners = 1;
+                    winners = 1u << p;
+                    winner = p;
                 }
                 else if(thisRank == highestRank)
                 {
-                    winners |= 1u<<p;
-                    ++numWinners;
+                    winners |= 1u << p;
+                    winner = p;
                 }
             }
 
             /* Step 2: Tiebreakers */
 
-            register ParlPlayer winner = -1;
-
             // Multiple winners, have to check Parliament
-            if(numWinners > 1)
+            if(winners & (winners - 1))
             {
-                register ParlSuit singlePlurality = parlGame_plurality(g);
+                const register ParlSuit singlePlurality = parlGame_plurality(g);
+                winner = -1;
 
-                // There exists a single plurality suit
+                /* It's impossible for two election candidates to be of the same suit -- that would mean they played the
+                 * same exact PM candidate -- so if there is a single plurality suit, at most one winner is of it. */
                 if(singlePlurality != INVALID_SUIT)
-                    // Find the player p whose PM candidate is of the plurality suit
-                    PARL_FOREACH_PLAYER(g, p)
-                        if(PARL_SUIT(g->elecCands[p].pmIdx) == singlePlurality)
+                    for(register unsigned int rest = winners; rest; rest &= rest - 1)
+                        if(PARL_SUIT(g->elecCands[PARL_LOWEST_IDX(rest)].pmIdx) == singlePlurality)
                         {
-                            /* We don't need to keep searching because it's impossible for two election candidates to
-                             * and be of the same suit -- that would mean they played the same exact PM candidate. If
-                             * we got here, we know this is the only candidate of this suit and thus the winner. */
-                            winner = p;
-                            goto winnerFound;
+                            winner = PARL_LOWEST_IDX(rest);
+                            break;
                         }
 
                 // Election canceled -- return everyone's calling cards to `knownHands`
-                PARL_FOREACH_PLAYER(g, p)
+                if(winner < 0)
                 {
-                    if(g->elecCands[p].callingCards == PARL_EMPTY_STACK)
-                        continue;
+                    for(register unsigned int rest = running; rest; rest &= rest - 1)
+                    {
+                        const register ParlPlayer p = PARL_LOWEST_IDX(rest);
 
-                    g->faceDownCards &= ~g->elecCands[p].callingCards;
-                    g->knownHands[p] |= g->elecCands[p].callingCards;
-                    g->handSizes[p] = g->elecCands[p].preCallNumCards;
-                }
+                        PARL_SET_STACK(PARL_ZOBRIST_FACE_DOWN, faceDownCards,
+                                       g->faceDownCards & ~g->elecCands[p].callingCards);
+                        PARL_SET_STACK_OF(PARL_ZOBRIST_KNOWN_HAND, p, knownHands[p],
+                                          g->knownHands[p] | g->elecCands[p].callingCards);
+                        PARL_SET_OF(PARL_ZOBRIST_HAND_SIZE, p, handSizes[p], g->elecCands[p].preCallNumCards);
+                    }
 
-                goto cancelElection;
-            }
-            // Only one winner -- find out who it is
-            else PARL_FOREACH_PLAYER(g, p)
-                if(winners & (1u<<p))
-                {
-                    winner = p;
-                    break;
+                    goto cancelElection;
                 }
-
-            winnerFound:;
+            }
 
             /* Step 3: Discard losing candidates' calling cards, confirm new PM */
 
-            if(g->pmPosition != PARL_NO_PM)
-            {
-                // Remove PM's calling cards from hand
-                parlRemoveCardsPartial(&g->knownHands[g->pmPosition], g->elecCands[g->pmPosition].callingCards);
-                parlRemoveCardsPartial(&g->faceDownCards, g->elecCands[g->pmPosition].callingCards);
-            }
+            // The old PM's government falls if they didn't win, whether or not they ran
+            if(g->pmPosition != PARL_NO_PM && winner != g->pmPosition)
+                PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard | PARL_CARD(g->pmCardIdx) | g->cabinet);
 
-            PARL_FOREACH_PLAYER(g, p)
+            // Only the candidates are visited, in a single pass
+            for(register unsigned int rest = running; rest; rest &= rest - 1)
             {
-                if(g->elecCands[p].callingCards == PARL_EMPTY_STACK)
-                    continue;
+                const register ParlPlayer p = PARL_LOWEST_IDX(rest);
+
+                // Calling cards have to come from the hand, so they all leave it regardless of the result
+                parlGame_removeFromHandOf(g, g->elecCands[p].callingCards, p);
 
                 if(p == winner)
                 {
                     /* p was and remains PM */
                     if(p == g->pmPosition)
                     {
-                        // Move calling cards and old PM card to cabinet -- new PM card is now somewhere in cabinet
-                        g->cabinet |= g->elecCands[p].callingCards | PARL_CARD(g->pmCardIdx);
-                        // Remove new PM card from Cabinet
-                        g->cabinet &= ~PARL_CARD(g->elecCands[p].pmIdx);
+                        // Move calling cards and old PM card to cabinet, except for the new PM card
+                        PARL_SET_STACK(PARL_ZOBRIST_CABINET, cabinet,
+                                       (g->cabinet | g->elecCands[p].callingCards | PARL_CARD(g->pmCardIdx))
+                                       & ~PARL_CARD(g->elecCands[p].pmIdx));
                         // Update PM card
-                        g->pmCardIdx = g->elecCands[p].pmIdx;
+                        PARL_SET(PARL_ZOBRIST_PM_CARD, pmCardIdx, g->elecCands[p].pmIdx);
                     }
                     /* No PM until now or PM lost election */
                     else
                     {
-                        // Remove calling cards from hand
-                        parlGame_removeFromHandOf(g, g->elecCands[p].callingCards, p);
-
                         // Update PM
-                        g->pmPosition = p;
-                        g->pmCardIdx = g->elecCands[p].pmIdx;
-                        g->cabinet = g->elecCands[p].callingCards & ~PARL_CARD(g->elecCands[p].pmIdx);
+                        PARL_SET(PARL_ZOBRIST_PM_POSITION, pmPosition, p);
+                        PARL_SET(PARL_ZOBRIST_PM_CARD, pmCardIdx, g->elecCands[p].pmIdx);
+                        PARL_SET_STACK(PARL_ZOBRIST_CABINET, cabinet,
+                                       g->elecCands[p].callingCards & ~PARL_CARD(g->elecCands[p].pmIdx));
                     }
                 }
-                /* p was PM but lost election */
-                else if(p == g->pmPosition)
-                {
-                    // Discard PM card and Cabinet
-                    g->discard |= PARL_CARD(g->pmCardIdx) | g->cabinet;
-                    // PM's calling cards were already removed from hand earlier
-                }
-                /* Non-PM player who lost election */
+                /* Player who lost election */
                 else
-                {
-                    // Remove calling cards from hand
-                    parlGame_removeFromHandOf(g, g->elecCands[p].callingCards, p);
                     // Discard calling cards
-                    g->discard |= g->elecCands[p].callingCards;
-                }
+                    PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard | g->elecCands[p].callingCards);
             }
 
             cancelElection:
 
-            free(g->elecCands);
-            g->elecCands = NULL;
-
+            PARL_FOREACH_PLAYER(g, p)
+                parlGame_clearElecCand(g, p);
             parlGame_revertToNormalModeAndTurn(g);
             parlGame_incTurn(g);
             return true;
 
         case APPOINT_BACKUP_PM:
-            if(parlRemoveCards(&g->cabinet, cardA))
+            if(!PARL_CONTAINS(g->cabinet, cardA))
                 return false;
 
-            g->pmCardIdx = idxA;
-            g->mode = NORMAL_MODE;
+            PARL_SET_STACK(PARL_ZOBRIST_CABINET, cabinet, g->cabinet - cardA);
+            PARL_SET(PARL_ZOBRIST_PM_CARD, pmCardIdx, idxA);
+            parlGame_revertToNormalModeAndTurn(g);
             parlGame_incTurn(g);
             return true;
 
         case ENDGAME_TRY_FORMATION:
-            if(g->pmPosition == PARL_NO_PM && !parlGame_removeFromHand(g, cardA))
+            // The PM runs with the PM card; everyone else plays a PM candidate from their hand
+            if(g->turn != g->pmPosition && (PARL_IS_JOKER(idxA) || !parlGame_removeFromHand(g, cardA)))
                 return false;
 
-            const register ParlIdx pmCandIdx = g->pmPosition == PARL_NO_PM ? idxA : g->pmCardIdx;
-
-            g->discard |= pmCandIdx;
-            g->cardToBeatIdx = pmCandIdx;
+            const register ParlIdx pmCandIdx = g->turn == g->pmPosition ? g->pmCardIdx : idxA;
 
-            g->coalitionSize = parlStackSize(PARL_FILTER_SUIT(g->parliament, PARL_SUIT(idxA)));
+            PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard | PARL_CARD(pmCandIdx));
+            PARL_SET(PARL_ZOBRIST_CARD_TO_BEAT, cardToBeatIdx, pmCandIdx);
 
             // PM card counts as MP for the PM
-            if(g->pmPosition != PARL_NO_PM)
-                ++g->coalitionSize;
+            PARL_SET(PARL_ZOBRIST_COALITION_SIZE, coalitionSize,
+                     PARL_STACK_SIZE(PARL_FILTER_SUIT(g->parliament, PARL_SUIT(pmCandIdx)))
+                     + (g->pmPosition != PARL_NO_PM));
 
             // Majority w/o blocking?
             if(g->coalitionSize > g->numPlayers)
             {
-                g->mode = GAME_OVER;
+                PARL_SET(PARL_ZOBRIST_MODE, mode, GAME_OVER);
                 return true;
             }
 
             // Needs coalition -- wait for blocks
             parlGame_saveNormalTurn(g);
-            g->turn = 0;
-            g->mode = BLOCK_COALITION_MODE;
+            PARL_SET(PARL_ZOBRIST_TURN, turn, 0);
+            PARL_SET(PARL_ZOBRIST_MODE, mode, BLOCK_COALITION_MODE);
             return true;
 
         case ENDGAME_PASS_FORMATION:
@@ -741,16 +1079,16 @@ bool parlGame_applyAction(ParlGame* const g,
 
         case ENDGAME_PM_FIRST:
             // Turn is currently set to PM
-            g->cycleStarter = g->pmPosition;
-            g->mode = ENDGAME_MODE;
-            g->endgameSkipPm = false;
+            PARL_SET(PARL_ZOBRIST_CYCLE_STARTER, cycleStarter, g->pmPosition);
+            PARL_SET(PARL_ZOBRIST_MODE, mode, ENDGAME_MODE);
+            PARL_SET(PARL_ZOBRIST_ENDGAME_SKIP_PM, endgameSkipPm, false);
             return true;
 
         case ENDGAME_PM_LAST:
             // Turn is currently set to PM
-            g->cycleStarter = PARL_NEXT_TURN(g);
-            g->mode = ENDGAME_MODE;
-            g->endgameSkipPm = true;
+            PARL_SET(PARL_ZOBRIST_CYCLE_STARTER, cycleStarter, PARL_NEXT_TURN(g));
+            PARL_SET(PARL_ZOBRIST_MODE, mode, ENDGAME_MODE);
+            PARL_SET(PARL_ZOBRIST_ENDGAME_SKIP_PM, endgameSkipPm, true);
 
             parlGame_incTurn(g);
             return true;
@@ -759,14 +1097,14 @@ bool parlGame_applyAction(ParlGame* const g,
             if(
                 !PARL_HIGHER_THAN(idxA, g->cardToBeatIdx)
                 || PARL_SUIT(idxA) != PARL_SUIT(g->cardToBeatIdx)
-                || !parlGame_handContains(g, cardA)
+                || !parlGame_removeFromHand(g, cardA)
             )
                 return false;
 
-            g->discard |= g->cardToBeatIdx;
-            g->cardToBeatIdx = idxA;
-            g->turn = g->currNormalTurn;
-            g->mode = COUNTER_BLOCK_COALITION_MODE;
+            PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard | PARL_CARD(g->cardToBeatIdx));
+            PARL_SET(PARL_ZOBRIST_CARD_TO_BEAT, cardToBeatIdx, idxA);
+            PARL_SET(PARL_ZOBRIST_TURN, turn, g->currNormalTurn);
+            PARL_SET(PARL_ZOBRIST_MODE, mode, COUNTER_BLOCK_COALITION_MODE);
             return true;
 
         case ENDGAME_NO_BLOCK_COALITION:
@@ -776,7 +1114,7 @@ bool parlGame_applyAction(ParlGame* const g,
             {
                 if(
                     g->coalitionSize
-                    + parlStackSize(
+                    + PARL_STACK_SIZE(
                         PARL_FILTER_SUIT(g->parliament,
                             PARL_COALITION_PARTNERS[PARL_SUIT(g->cardToBeatIdx)]
                         )
@@ -785,8 +1123,8 @@ bool parlGame_applyAction(ParlGame* const g,
                 )
                     goto coalitionFail;
 
-                g->mode = GAME_OVER;
-                g->turn = g->currNormalTurn;
+                PARL_SET(PARL_ZOBRIST_MODE, mode, GAME_OVER);
+                PARL_SET(PARL_ZOBRIST_TURN, turn, g->currNormalTurn);
             }
             return true;
 
@@ -794,42 +1132,105 @@ bool parlGame_applyAction(ParlGame* const g,
             if(
                 !PARL_HIGHER_THAN(idxA, g->cardToBeatIdx)
                 || PARL_SUIT(idxA) != PARL_SUIT(g->cardToBeatIdx)
-                || !parlGame_handContains(g, cardA)
+                || !parlGame_removeFromHand(g, cardA)
             )
                 return false;
 
-            g->discard |= g->cardToBeatIdx;
-            g->cardToBeatIdx = idxA;
-            g->turn = 0;
-            g->mode = BLOCK_COALITION_MODE;
+            PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard | PARL_CARD(g->cardToBeatIdx));
+            PARL_SET(PARL_ZOBRIST_CARD_TO_BEAT, cardToBeatIdx, idxA);
+            PARL_SET(PARL_ZOBRIST_TURN, turn, 0);
+            PARL_SET(PARL_ZOBRIST_MODE, mode, BLOCK_COALITION_MODE);
             return true;
 
         case ENDGAME_NO_COUNTER_BLOCK_COALITION:
         coalitionFail:
-            g->mode = ENDGAME_MODE;
-            g->discard |= g->cardToBeatIdx;
-            parlGame_revertToNormalModeAndTurn(g);
+            PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard | PARL_CARD(g->cardToBeatIdx));
+            PARL_SET(PARL_ZOBRIST_TURN, turn, g->currNormalTurn);
+            PARL_SET(PARL_ZOBRIST_MODE, mode, ENDGAME_MODE);
             parlGame_incTurnEndgame(g);
 
             return true;
     }
 }
 
+bool parlGame_resolveImpeachment(ParlGame* const g, const unsigned int raisers)
+{
+    if((g->mode != BLOCK_IMPEACH_MODE && g->mode != REIMPEACH_MODE) || !g->allHandsKnown)
+        return false;
+
+    const register ParlSuit suit = PARL_SUIT(g->impeachedMpIdx);
+    const register ParlStack ace = PARL_RS_TO_CARD(PARL_ACE_RANK, suit);
+
+    for(;;)
+    {
+        if(raisers & 1u << g->turn)
+        {
+            const register ParlStack hand = g->knownHands[g->turn];
+
+            // Aces beat jokers, and that's the end of it
+            if(PARL_IS_JOKER(g->cardToBeatIdx))
+            {
+                if(hand & ace)
+                {
+                    parlGame_confirmImpeachedMp(g);
+                    break;
+                }
+            }
+            else
+            {
+                const register ParlStack raises =
+                    hand & PARL_RANKS_ABOVE(PARL_RANK(g->cardToBeatIdx)) << suit * PARL_NUM_RANKS;
+
+                if(raises)
+                {
+                    const register ParlIdx i = PARL_LOWEST_IDX(raises);
+
+                    PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard | PARL_CARD(g->cardToBeatIdx));
+                    parlGame_removeFromHand(g, PARL_CARD(i));
+                    PARL_SET(PARL_ZOBRIST_CARD_TO_BEAT, cardToBeatIdx, i);
+                    PARL_SET(PARL_ZOBRIST_TURN, turn, 0);
+                    PARL_SET(PARL_ZOBRIST_MODE, mode, REIMPEACH_MODE);
+                    continue;
+                }
+            }
+        }
+
+        parlGame_incTurn(g);
+
+        if(g->turn == 0)
+        {
+            parlGame_confirmImpeachedMp(g);
+            break;
+        }
+    }
+
+    return true;
+}
+
 bool parlGame_handContains(const ParlGame* g, const ParlStack s)
 {
-    if(g->turn == g->myPosition)
-        return PARL_CONTAINS(g->knownHands[g->turn], s);
+    return parlGame_handOfContains(g, s, g->turn);
+}
 
+bool parlGame_handOfContains(const ParlGame* const g, const ParlStack s, const ParlPlayer p)
+{
+    if(PARL_KNOWS_HAND(g, p))
+        return PARL_CONTAINS(g->knownHands[p], s);
+
+#if PARL_DISTINCT_JOKERS
+    return PARL_CONTAINS(g->knownHands[p] | g->faceDownCards, s);
+#else
     const register ParlStack nj = PARL_WITHOUT_JOKERS(s);
-    return nj == ((nj & g->knownHands[g->turn]) + (nj & g->faceDownCards))
+    return nj == ((nj & g->knownHands[p]) + (nj & g->faceDownCards))
         &&
             PARL_NUM_JOKERS(s) <=
-            PARL_NUM_JOKERS(g->faceDownCards) + PARL_NUM_JOKERS(g->knownHands[g->turn]);
+            PARL_NUM_JOKERS(g->faceDownCards) + PARL_NUM_JOKERS(g->knownHands[p]);
+#endif
 }
 
 void parlGame_incTurn(ParlGame* const g)
 {
-    g->turn = PARL_NEXT_TURN(g);
+    PARL_SET(PARL_ZOBRIST_TURN, turn, PARL_NEXT_TURN(g));
 }
 
 void parlGame_incTurnEndgame(ParlGame* const g)
@@ -849,52 +1250,63 @@ void parlGame_incTurnEndgame(ParlGame* const g)
     {
         // ...but not the PM? Then the PM needs to have a go
         if(g->endgameSkipPm)
-            g->turn = g->pmPosition;
+            PARL_SET(PARL_ZOBRIST_TURN, turn, g->pmPosition);
         // ...including the PM? Then dissolve Parliament
         else
         {
             dissolveParliament:
 
-            g->pmPosition = PARL_NO_PM;
+            // The PM card is shuffled back in with everything else
+            if(g->pmPosition != PARL_NO_PM)
+                PARL_SET_STACK(PARL_ZOBRIST_DISCARD, discard, g->discard | PARL_CARD(g->pmCardIdx));
+
+            PARL_SET(PARL_ZOBRIST_PM_POSITION, pmPosition, PARL_NO_PM);
+            PARL_SET(PARL_ZOBRIST_PM_CARD, pmCardIdx, PARL_NO_PM);
 
             // Move entire discard pile to draw deck
-            g->drawDeckSize = parlStackSize(g->discard);
-            parlMoveCards(&g->faceDownCards, &g->discard, g->discard);
+            PARL_SET(PARL_ZOBRIST_DRAW_DECK_SIZE, drawDeckSize, PARL_STACK_SIZE(g->discard));
+            parlGame_moveCards(g, &g->faceDownCards, &g->discard, g->discard);
 
-            g->turn = g->cycleStarter;
-            g->mode = NORMAL_MODE;
+            PARL_SET(PARL_ZOBRIST_TURN, turn, g->cycleStarter);
+            PARL_SET(PARL_ZOBRIST_MODE, mode, NORMAL_MODE);
         }
     }
 }
 
 void parlGame_saveNormalTurn(ParlGame *const g)
 {
-    g->currNormalTurn = g->turn;
+    PARL_SET(PARL_ZOBRIST_CURR_NORMAL_TURN, currNormalTurn, g->turn);
 }
 
 void parlGame_revertToNormalModeAndTurn(ParlGame *const g)
 {
-    g->mode = NORMAL_MODE;
-    g->turn = g->currNormalTurn;
+    PARL_SET(PARL_ZOBRIST_MODE, mode, NORMAL_MODE);
+    PARL_SET(PARL_ZOBRIST_TURN, turn, g->currNormalTurn);
 }
 
 void parlGame_moveToEndgame(ParlGame* const g)
 {
     // Move Cabinet to PM's hand
-    g->knownHands[g->pmPosition] |= g->cabinet;
-    g->cabinet = PARL_EMPTY_STACK;
+    if(g->pmPosition != PARL_NO_PM)
+    {
+        PARL_SET_STACK_OF(PARL_ZOBRIST_KNOWN_HAND, g->pmPosition, knownHands[g->pmPosition],
+                          g->knownHands[g->pmPosition] | g->cabinet);
+        PARL_SET_OF(PARL_ZOBRIST_HAND_SIZE, g->pmPosition, handSizes[g->pmPosition],
+                    g->handSizes[g->pmPosition] + PARL_STACK_SIZE(g->cabinet));
+    }
+    PARL_SET_STACK(PARL_ZOBRIST_CABINET, cabinet, PARL_EMPTY_STACK);
 
     if(g->pmPosition == PARL_NO_PM)
     {
-        g->mode = ENDGAME_MODE;
-        g->cycleStarter = PARL_NEXT_TURN(g);
-        g->endgameSkipPm = false;
+        PARL_SET(PARL_ZOBRIST_MODE, mode, ENDGAME_MODE);
+        PARL_SET(PARL_ZOBRIST_CYCLE_STARTER, cycleStarter, PARL_NEXT_TURN(g));
+        PARL_SET(PARL_ZOBRIST_ENDGAME_SKIP_PM, endgameSkipPm, false);
         parlGame_incTurn(g);
     }
     else
     {
-        g->mode = PM_CHOOSE_FIRST_LAST_MODE;
-        g->turn = g->pmPosition;
+        PARL_SET(PARL_ZOBRIST_MODE, mode, PM_CHOOSE_FIRST_LAST_MODE);
+        PARL_SET(PARL_ZOBRIST_TURN, turn, g->pmPosition);
     }
 }
 
@@ -903,17 +1315,33 @@ bool parlGame_removeFromHand(ParlGame* const g, const ParlStack s)
     if(!parlGame_removeFromHandOf(g, s, g->turn))
         return false;
 
-    DECREASE_HAND_SIZE(parlStackSize(s));
+    DECREASE_HAND_SIZE(PARL_STACK_SIZE(s));
     return true;
 }
 
 bool parlGame_removeFromHandOf(ParlGame* const g, const ParlStack s, const ParlPlayer p)
 {
-    if(!parlGame_handContains(g, s))
+    if(!parlGame_handOfContains(g, s, p))
         return false;
 
-    parlRemoveCardsPartial(&g->knownHands[p], s);
-    parlRemoveCardsPartial(&g->faceDownCards, s);
+    ParlStack hand = g->knownHands[p], faceDown = g->faceDownCards;
+
+#if PARL_DISTINCT_JOKERS
+    // Every card of `s`, jokers included, is in exactly one of the two
+    hand &= ~s;
+    faceDown &= ~s;
+#else
+    // Take jokers out of the known hand first and only take the rest from the face-down cards
+    const register unsigned int numJokers = PARL_NUM_JOKERS(s);
+    const register unsigned int numKnownJokers = PARL_NUM_JOKERS(hand);
+    const register unsigned int jokersFromHand = numJokers < numKnownJokers ? numJokers : numKnownJokers;
+
+    parlRemoveCardsPartial(&hand, PARL_WITHOUT_JOKERS(s) + jokersFromHand * PARL_JOKER_CARD);
+    parlRemoveCardsPartial(&faceDown, PARL_WITHOUT_JOKERS(s) + (numJokers - jokersFromHand) * PARL_JOKER_CARD);
+#endif
+
+    PARL_SET_STACK_OF(PARL_ZOBRIST_KNOWN_HAND, p, knownHands[p], hand);
+    PARL_SET_STACK(PARL_ZOBRIST_FACE_DOWN, faceDownCards, faceDown);
 
     return true;
 }
@@ -923,14 +1351,29 @@ bool parlGame_moveFromHandTo(ParlGame* const g, ParlStack* const dest, const Par
     if(!parlGame_removeFromHand(g, s))
         return false;
 
+    g->hash ^= parlZobrist_stackDiff(parlGame_stackField(g, dest), 0, *dest, *dest + s);
     *dest += s;
     return true;
 }
 
+void parlGame_recountParliament(ParlGame* const g)
+{
+    PARL_FOREACH_SUIT(s)
+        g->parliamentSuitSizes[s] = PARL_STACK_SIZE(PARL_FILTER_SUIT(g->parliament, s));
+
+    parlGame_updatePluralities(g);
+}
+
 void parlGame_confirmImpeachedMp(ParlGame* const g)
 {
-    parlMoveCards(&g->discard, &g->parliament, PARL_CARD(g->impeachedMpIdx));
-    g->parliament |= PARL_CARD(g->cardToBeatIdx);
+    parlGame_moveCards(g, &g->discard, &g->parliament, PARL_CARD(g->impeachedMpIdx));
+    // Not |= since the replacement may be a joker
+    PARL_SET_STACK(PARL_ZOBRIST_PARLIAMENT, parliament, g->parliament + PARL_CARD(g->cardToBeatIdx));
+
+    parlGame_countMp(g, g->impeachedMpIdx, -1);
+    parlGame_countMp(g, g->cardToBeatIdx, 1);
+    parlGame_updatePluralities(g);
+
     parlGame_revertToNormalModeAndTurn(g);
     parlGame_incTurn(g);
 }
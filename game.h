@@ -9,7 +9,6 @@
 
 /*
  * TODO Possible future optimizations:
- * - Make knownHands the same size every time so we don't need to call `calloc`, which is slow afaik
  * - Get rid of modes, just precompute legal moves at the end of every action
  */
 
@@ -20,8 +19,22 @@
 
 #define PARL_NO_PM -1
 
+#define PARL_NO_WINNER -1
+
 #define PARL_NO_ARG -1
 
+/**
+ * Whether `i`, read out of a `ParlIdx` bitfield such as `ParlMove.idxA`, is `PARL_NO_ARG`. It's stored as the all-ones
+ * `ParlIdx` of `PARL_IDX_WIDTH` bits, so that's what it reads back as.
+ */
+#define PARL_IS_NO_ARG(i) ((i) == ((ParlIdx)PARL_NO_ARG & ((1u << PARL_IDX_WIDTH) - 1)))
+
+/**
+ * Returns the card of an action's argument. `PARL_NO_ARG` is far out of range of a shift, so unused arguments become
+ * empty stacks instead.
+ */
+#define PARL_ARG_CARD(i) ((i) < 64 ? PARL_CARD(i) : PARL_EMPTY_STACK)
+
 /**
  * The maximum number of cards a player is allowed to have in their hand.
  */
@@ -33,9 +46,16 @@
 #define PARL_MAX_NUM_PLAYERS 16
 
 /**
- * The width, in bits, of a player ID.
+ * The width, in bits, of a player ID. Player IDs are signed so that `PARL_NO_PM` fits, so this needs one more bit than
+ * the highest player index.
  */
-#define PARL_PLAYER_WIDTH 4
+#define PARL_PLAYER_WIDTH 5
+
+/**
+ * An upper bound on the number of moves `parlGame_generateMoves` can produce for any state. Buffers of this size never
+ * overflow.
+ */
+#define PARL_MAX_MOVES 8192
 
 /**
  * Returns the known player's hand.
@@ -47,6 +67,16 @@
  */
 #define PARL_MY_TURN(g) (g->turn == g->myPosition)
 
+/**
+ * Returns whether every card in player `p`'s hand is in `knownHands[p]`.
+ */
+#define PARL_KNOWS_HAND(g, p) ((p) == (g)->myPosition || (g)->allHandsKnown)
+
+/**
+ * Returns the player who won, or `PARL_NO_WINNER` if the game isn't over.
+ */
+#define PARL_WINNER(g) ((g)->mode == GAME_OVER ? (ParlPlayer)(g)->turn : PARL_NO_WINNER)
+
 /**
  * Returns the index of the player who is due to play next.
  */
@@ -131,8 +161,8 @@ typedef enum ParlAction
     VOTE_NO_CONF,
 
     /**
-     * In NORMAL_MODE mode: legal if the player is the PM, Cabinet isn't empty, and Parliament isn't empty. `idxA` is the
-     * Cabinet card and `idxB` is the MP.
+     * In NORMAL_MODE mode: legal if the player is the PM, Cabinet isn't empty, and Parliament has an MP that isn't a
+     * joker. `idxA` is the Cabinet card and `idxB` is the MP.
      */
     CABINET_RESHUFFLE,
 
@@ -180,21 +210,43 @@ typedef enum ParlAction
     ENDGAME_NO_COUNTER_BLOCK_COALITION,
 } ParlAction;
 
+/**
+ * An action together with all of its arguments. Unused arguments are `PARL_NO_ARG`, which is stored as the all-ones
+ * `ParlIdx`.
+ */
+typedef struct ParlMove
+{
+    ParlAction action : 8;
+    ParlIdx idxA : PARL_IDX_WIDTH;
+    ParlIdx idxB : PARL_IDX_WIDTH;
+    ParlIdx idxC : PARL_IDX_WIDTH;
+} ParlMove;
+
 /**
  * @brief A Parliament game state from one player's perspective, referred to throughout the code as the "known player".
+ *
+ * @details
+ * A `ParlGame` doesn't own any memory outside of itself, so it can be copied with `memcpy` or plain assignment.
  */
 typedef struct ParlGame
 {
     /**
      * The number of players in the game.
      */
-    ParlPlayer numPlayers : 5;
+    ParlPlayer numPlayers : PARL_PLAYER_WIDTH + 1;
 
     /**
      * The number of turns away from the first turn that the known player sits.
      */
     ParlPlayer myPosition : PARL_PLAYER_WIDTH;
 
+    /**
+     * Set when this is a full-information game in which every player's whole hand is in `knownHands` and
+     * `faceDownCards` is exactly the draw deck. Such games are driven through perfect.h, which decides what each `DRAW`
+     * draws.
+     */
+    bool allHandsKnown : 1;
+
     /* Essentials -- required to enforce rules */
 
     /**
@@ -276,6 +328,9 @@ typedef struct ParlGame
 
         COUNTER_BLOCK_COALITION_MODE,
 
+        /**
+         * Active when a coalition has formed. The player whose turn it is won.
+         */
         GAME_OVER
     } mode : 4;
 
@@ -304,13 +359,13 @@ typedef struct ParlGame
     ParlPlayer cycleStarter : PARL_PLAYER_WIDTH;
 
     /**
-     * A dynamically allocated array of all the candidates in this election.
+     * All the candidates in this election, indexed by player. All zero outside of `ELECTION_MODE`.
      */
     struct ParlElectionCand {
         ParlStack callingCards;
         ParlIdx pmIdx : PARL_IDX_WIDTH;
         ParlIdx preCallNumCards : PARL_IDX_WIDTH;
-    } *elecCands;
+    } elecCands[PARL_MAX_NUM_PLAYERS];
 
     /* Derived information */
 
@@ -322,22 +377,94 @@ typedef struct ParlGame
     /**
      * Cards that are known to be in certain players' hands.
      */
-    ParlStack* knownHands;
+    ParlStack knownHands[PARL_MAX_NUM_PLAYERS];
 
     /**
      * All cards that are either in the draw pile or someone's hand. These are combined since we can't see either of them.
      */
     ParlStack faceDownCards;
+
+    /**
+     * The Zobrist hash of everything above (see zobrist.h), kept up to date by every function in game.c that changes
+     * the game, by XOR-ing in the keys of whatever it changes.
+     */
+    uint64_t hash;
+
+    /**
+     * The number of MPs of each suit in `parliament`, not counting jokers.
+     */
+    uint8_t parliamentSuitSizes[PARL_NUM_SUITS];
+
+    /**
+     * The suits with the most MPs, as returned by `parlGame_tiedPluralities`. This and `parliamentSuitSizes` are kept
+     * up to date by every action that changes `parliament`, and are not part of `hash` since they follow from it.
+     */
+    uint8_t pluralities;
 } ParlGame;
 
+/**
+ * @brief Everything needed to take back one action applied with `parlGame_applyActionUndoable`.
+ *
+ * @details
+ * This is meant to live on the stack of a search function, one per ply, so that speculative actions can be applied and
+ * taken back in place instead of copying the game before each one. It only holds the parts of the game that an action
+ * can change: the stacks that aren't per-player, the fields that track whose turn it is and what is being resolved,
+ * and the hands and candidacies of the players in `players`.
+ */
+typedef struct ParlUndo
+{
+    /* The fields of the same names in the game before the action */
+
+    uint64_t hash;
+
+    ParlStack cabinet;
+    ParlStack parliament;
+    ParlStack discard;
+    ParlStack faceDownCards;
+
+    ParlPlayer turn : PARL_PLAYER_WIDTH;
+    ParlPlayer pmPosition : PARL_PLAYER_WIDTH;
+    ParlIdx pmCardIdx : PARL_IDX_WIDTH;
+    unsigned int drawDeckSize : 6;
+    enum ParlGameMode mode : 4;
+    unsigned int coalitionSize : 6;
+    bool endgameSkipPm : 1;
+    ParlPlayer currNormalTurn : PARL_PLAYER_WIDTH;
+    ParlIdx cardToBeatIdx : PARL_IDX_WIDTH;
+    ParlIdx impeachedMpIdx : PARL_IDX_WIDTH;
+    ParlPlayer cycleStarter : PARL_PLAYER_WIDTH;
+
+    uint8_t parliamentSuitSizes[PARL_NUM_SUITS];
+    uint8_t pluralities;
+
+    /**
+     * The number of players saved in `players`. Only the player whose turn it was and the PM can have their hand
+     * changed by an action, except for the end of an election, which can change anyone's, so every player is saved in
+     * `ELECTION_MODE`.
+     */
+    int numPlayers;
+
+    /**
+     * The per-player state of each player the action could change.
+     */
+    struct ParlUndoPlayer
+    {
+        ParlPlayer p;
+        int8_t handSize;
+        struct ParlElectionCand elecCand;
+        ParlStack knownHand;
+    } players[PARL_MAX_NUM_PLAYERS];
+} ParlUndo;
+
 /**
  * @brief Initialize the game from midgame.
  * @param g The g to initialize.
- * @param numJokers The number of jokers in the deck.
+ * @param numJokers The number of jokers in the deck. At most `PARL_MAX_JOKERS`, and few enough that the draw deck
+ * starts with fewer than 64 cards.
  * @param numPlayers Same as the field.
  * @param myPosition Same as the field.
  * @param myFirstCardIdx The first card in the known player's hand, obtained from pregame.
- * @return Whether the initialization was successful.
+ * @return Whether the initialization was successful, which is false if `numJokers` is out of range.
  */
 bool parlGame_init(ParlGame* g,
                    int numJokers,
@@ -347,16 +474,17 @@ bool parlGame_init(ParlGame* g,
 
 /**
  * @brief Free memory allocated for a `ParlGame`, not including the `ParlGame` struct itself.
- * @note If you dynamically allocated memory to store the `ParlGame` itself, you must `free` it separately.
+ * @note A `ParlGame` no longer allocates anything, so this does nothing. If you dynamically allocated memory to store
+ * the `ParlGame` itself, you must `free` it separately.
  * @param g
  */
 void parlGame_free(const ParlGame* g);
 
 /**
- * @brief Deep-copies a ParlGame from `orig` to `dest`.
+ * @brief Copies a ParlGame from `orig` to `dest`. This is the same as `*dest = *orig`.
  * @param dest
  * @param orig
- * @return Whether the initialization was successful.
+ * @return Whether the copy was successful, which is always.
  */
 bool parlGame_deepCopy(ParlGame* dest, const ParlGame* orig);
 
@@ -365,9 +493,84 @@ bool parlGame_deepCopy(ParlGame* dest, const ParlGame* orig);
  * @return All legal actions in the game `g` in the current state, where a bit's index corresponds to its ID as a
  * `ParlAction` and a set bit means the move is legal.
  * @note For actions that are only legal when cards in hidden hands are available, they are assumed to be legal.
+ * @note This is a superset of the actions of the moves from `parlGame_generateMoves`, since a set bit only means that
+ * `parlGame_applyAction` might accept the action. A bit can be set with no move generated for it only for these:
+ * - `CALL_ELECTION`, `VOTE_NO_CONF`, and `IMPEACH_PM`, when the cards would have to include more cards we haven't
+ *   seen than the player has hidden.
+ * - `REIMPEACH`, `BLOCK_IMPEACH`, `CONTEST_ELECTION`, `ENDGAME_TRY_FORMATION`, `ENDGAME_BLOCK_COALITION`, and
+ *   `ENDGAME_COUNTER_BLOCK_COALITION`, which are always set in their modes whether or not the player has a card that
+ *   could be played.
  */
 unsigned int parlGame_legalActions(const ParlGame* g);
 
+/**
+ * @brief Lists every legal action in `g` together with its arguments.
+ *
+ * @details
+ * Every move written to `out` is accepted by `parlGame_applyAction` and its action is in `parlGame_legalActions`. When
+ * it is the known player's turn to draw, there is one `SELF_DRAW` for each face-down card. When it's another player's
+ * turn, the cards they can play come from `parlGame_possibleHand`, and a move that plays several cards uses at most as
+ * many cards we haven't seen as they have hidden. This is narrower than `parlGame_handContains`, which is why
+ * `parlGame_legalActions` can have actions with no moves. Moves whose arguments are unordered sets of cards, such as
+ * calling cards, are only listed once, with the cards in ascending order.
+ *
+ * @param g
+ * @param out The buffer to write moves to.
+ * @param cap The number of moves that fit in `out`. `PARL_MAX_MOVES` is always enough.
+ * @return The number of legal moves. If this is greater than `cap`, only the first `cap` moves were written.
+ */
+int parlGame_generateMoves(const ParlGame* g, ParlMove* out, int cap);
+
+/**
+ * @brief Same as `parlGame_applyAction` but takes a `ParlMove`.
+ * @param g
+ * @param m
+ * @return Whether the move is legal.
+ */
+bool parlGame_applyMove(ParlGame* g, ParlMove m);
+
+/**
+ * @brief Same as `parlGame_applyAction`, but records what is needed to undo the action in `u`.
+ * @note Unlike `parlGame_applyAction`, `g` is left untouched if the action turns out to be illegal.
+ * @param g
+ * @param u The undo record to fill in. Pass it to `parlGame_undoAction` to take the action back.
+ * @param a
+ * @param idxA
+ * @param idxB
+ * @param idxC
+ * @return Whether the action is legal with the specified arguments.
+ */
+bool parlGame_applyActionUndoable(ParlGame* g,
+                                  ParlUndo* u,
+                                  ParlAction a,
+                                  ParlIdx idxA,
+                                  ParlIdx idxB,
+                                  ParlIdx idxC);
+
+/**
+ * @brief Same as `parlGame_applyActionUndoable` but takes a `ParlMove`.
+ * @param g
+ * @param u
+ * @param m
+ * @return Whether the move is legal.
+ */
+bool parlGame_applyMoveUndoable(ParlGame* g, ParlUndo* u, ParlMove m);
+
+/**
+ * @brief Restores `g` to exactly how it was before the action that filled in `u`.
+ * @note Actions must be undone in the reverse order that they were applied.
+ * @param g
+ * @param u
+ */
+void parlGame_undoAction(ParlGame* g, const ParlUndo* u);
+
+/**
+ * @param g
+ * @return All cards that the player whose turn it is might be holding: their hand if they are the known player, or
+ * otherwise everything in `knownHands` and `faceDownCards`.
+ */
+ParlStack parlGame_possibleHand(const ParlGame* g);
+
 /**
  * @param g
  * @return The tied plurality suits, with the indices of set bits being the indices of tied plurality suits.
@@ -403,6 +606,25 @@ bool parlGame_applyAction(ParlGame* g,
                           ParlIdx idxC
                           );
 
+/**
+ * @brief Plays out the rest of an impeachment in one step, as a macro-move.
+ *
+ * @details
+ * Players are polled in turn, the same as with `BLOCK_IMPEACH`/`REIMPEACH` and `NO_BLOCK_IMPEACH`/`NO_REIMPEACH`.
+ * Each player in `raisers` blocks or re-impeaches whenever they can, with their lowest card of the impeached MP's suit
+ * that beats `cardToBeatIdx`, or with the ace of that suit if `cardToBeatIdx` is a joker, which ends the impeachment
+ * right away. Everyone else passes. A raise starts the poll over from player 0, and once a poll gets all the way round
+ * with nobody raising, the impeachment is over.
+ *
+ * `g` ends up exactly as it would after playing those moves one at a time with `parlGame_applyAction`, hash included.
+ * Nothing is drawn, so this also works on `ParlPerfectGame.g`.
+ *
+ * @param g A game with `allHandsKnown` in `BLOCK_IMPEACH_MODE` or `REIMPEACH_MODE`.
+ * @param raisers The players who raise when they can, with bit `p` for player `p`.
+ * @return Whether `g` was in an impeachment that could be resolved. If not, `g` is left untouched.
+ */
+bool parlGame_resolveImpeachment(ParlGame* g, unsigned int raisers);
+
 /**
  * @param g
  * @param s
@@ -410,6 +632,14 @@ bool parlGame_applyAction(ParlGame* g,
  */
 bool parlGame_handContains(const ParlGame* g, ParlStack s);
 
+/**
+ * @param g
+ * @param s
+ * @param p
+ * @return Whether the hand of the player `p` contains `s` completely.
+ */
+bool parlGame_handOfContains(const ParlGame* g, ParlStack s, ParlPlayer p);
+
 /**
  * @brief Runs this line of code: g->turn = PARL_NEXT_TURN(g);
  * @note For internal use only. Do not call.
@@ -475,6 +705,13 @@ bool parlGame_removeFromHandOf(ParlGame* g, ParlStack s, ParlPlayer p);
  */
 bool parlGame_moveFromHandTo(ParlGame* g, ParlStack* dest, ParlStack s);
 
+/**
+ * @brief Recomputes `parliamentSuitSizes` and `pluralities` from scratch, for when `parliament` was set directly instead
+ * of through an action.
+ * @param g
+ */
+void parlGame_recountParliament(ParlGame* g);
+
 /**
  * @brief Ends the current impeachment stack.
  * @note For internal use only. Do not call.
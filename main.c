@@ -147,6 +147,6 @@ int main(void)
     parlTimer_stop(&t);
     printParlStack(g.faceDownCards);
     parlGame_free(&g);
-    printf("\nTIME: %d μs\n", parlTimer_microSecs(&t));
+    printf("\nTIME: %lld μs\n", (long long)parlTimer_microSecs(&t));
     return 0;
 }
@@ -0,0 +1,88 @@
+#include "perfect.h"
+#include "zobrist.h"
+
+bool parlPerfect_init(ParlPerfectGame* const pg, const int numJokers, const int numPlayers, const uint64_t seed)
+{
+    ParlGame g;
+    ParlWorld w;
+    ParlRng r;
+
+    parlRng_seed(&r, seed);
+
+    // Deal player 0's first card, then let the sampler deal everything else around it
+    const register ParlIdx firstCard = parlRng_below(&r, PARL_NUM_NON_JOKER_CARDS + numJokers);
+
+    if(!parlGame_init(&g, numJokers, numPlayers, 0, PARL_IS_JOKER(firstCard) ? PARL_JOKER_IDX : firstCard)
+        || !parlWorld_sample(&w, &g, &r))
+        return false;
+
+    parlPerfect_fromWorld(pg, &g, &w, parlRng_next(&r));
+    return true;
+}
+
+void parlPerfect_fromWorld(ParlPerfectGame* const pg, const ParlGame* const g, const ParlWorld* const w, const uint64_t seed)
+{
+    pg->g = *g;
+    pg->g.allHandsKnown = true;
+    pg->g.faceDownCards = PARL_EMPTY_STACK;
+
+    PARL_FOREACH_PLAYER(g, p)
+        pg->g.knownHands[p] = w->hands[p];
+
+    for(register int i = 0; i < w->drawDeckSize; ++i)
+    {
+        pg->drawDeck[i] = w->drawDeck[i];
+        pg->g.faceDownCards += PARL_CARD(w->drawDeck[i]);
+    }
+
+    pg->g.hash = parlZobrist_hash(&pg->g);
+    parlRng_seed(&pg->rng, seed);
+}
+
+bool parlPerfect_applyAction(ParlPerfectGame* const pg,
+                             const ParlAction a,
+                             const ParlIdx idxA,
+                             const ParlIdx idxB,
+                             const ParlIdx idxC)
+{
+    ParlGame* const g = &pg->g;
+    const register unsigned int prevDrawDeckSize = g->drawDeckSize;
+
+    if(a == DRAW || a == SELF_DRAW)
+    {
+        // To the rules, drawing a card everyone can see is the same as the known player drawing a card
+        if(
+            !prevDrawDeckSize
+            || !parlGame_applyAction(g, SELF_DRAW, pg->drawDeck[prevDrawDeckSize - 1], PARL_NO_ARG, PARL_NO_ARG)
+        )
+            return false;
+    }
+    else if(!parlGame_applyAction(g, a, idxA, idxB, idxC))
+        return false;
+
+    // Parliament was dissolved and the discard pile became the draw deck
+    if(g->drawDeckSize > prevDrawDeckSize)
+        parlWorld_shuffleDeck(pg->drawDeck, g->faceDownCards, &pg->rng);
+
+    return true;
+}
+
+bool parlPerfect_applyMove(ParlPerfectGame* const pg, const ParlMove m)
+{
+    return parlPerfect_applyAction(pg, m.action, m.idxA, m.idxB, m.idxC);
+}
+
+ParlPlayer parlPerfect_playout(ParlPerfectGame* const pg, ParlRng* const r, register int maxPlies)
+{
+    ParlMove moves[PARL_MAX_MOVES];
+
+    for(; maxPlies > 0 && pg->g.mode != GAME_OVER; --maxPlies)
+    {
+        const register int numMoves = parlGame_generateMoves(&pg->g, moves, PARL_MAX_MOVES);
+
+        if(!numMoves || !parlPerfect_applyMove(pg, moves[parlRng_below(r, numMoves)]))
+            break;
+    }
+
+    return PARL_WINNER(&pg->g);
+}
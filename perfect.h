@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @brief A full-information version of `ParlGame` in which every hand and the order of the draw deck are known.
+ *
+ * @details
+ * This is meant for simulating games, for example in the playouts of a search, rather than for following a real one.
+ * It uses the same rules as game.c. The underlying `ParlGame` has `allHandsKnown` set, so every hand is treated the way
+ * the known player's hand is in a normal `ParlGame`. The only thing that works differently is drawing, which takes the
+ * top card of the draw deck instead of an unknown card.
+ *
+ * Legal actions and moves come from `parlGame_legalActions` and `parlGame_generateMoves` on the underlying game.
+ * Because nothing has to be inferred, there are far fewer moves to generate than for the same position in a normal
+ * `ParlGame`. Actions must be applied with `parlPerfect_applyAction` so the draw deck stays in sync.
+ */
+
+#ifndef PARLIAMENT_PERFECT_H
+#define PARLIAMENT_PERFECT_H
+
+#include "game.h"
+#include "rng.h"
+#include "world.h"
+
+typedef struct ParlPerfectGame
+{
+    /**
+     * The game. Every player's whole hand is in `knownHands`, and `faceDownCards` is exactly the draw deck.
+     */
+    ParlGame g;
+
+    /**
+     * The draw deck in order. See `ParlWorld.drawDeck`.
+     */
+    uint8_t drawDeck[PARL_MAX_DRAW_DECK_SIZE];
+
+    /**
+     * Shuffles the discard pile when it becomes the draw deck again.
+     */
+    ParlRng rng;
+} ParlPerfectGame;
+
+/**
+ * @brief Deals a new game.
+ * @param pg
+ * @param numJokers The number of jokers in the deck.
+ * @param numPlayers
+ * @param seed Decides the deal and every reshuffle after it.
+ * @return Whether the game could be dealt, which is false if `parlGame_init` rejects `numJokers` or `numPlayers`.
+ */
+bool parlPerfect_init(ParlPerfectGame* pg, int numJokers, int numPlayers, uint64_t seed);
+
+/**
+ * @brief Makes a full-information game out of `g` with the face-down cards laid out as in `w`.
+ * @param pg
+ * @param g
+ * @param w A world sampled from `g` with `parlWorld_sample`.
+ * @param seed Decides every reshuffle after this.
+ */
+void parlPerfect_fromWorld(ParlPerfectGame* pg, const ParlGame* g, const ParlWorld* w, uint64_t seed);
+
+/**
+ * @brief Applies an action the same way as `parlGame_applyAction`, except that `DRAW` draws the top card of the
+ * draw deck.
+ * @param pg
+ * @param a `SELF_DRAW` is treated as `DRAW`, and its argument is ignored.
+ * @param idxA
+ * @param idxB
+ * @param idxC
+ * @return Whether the action is legal with the specified arguments.
+ */
+bool parlPerfect_applyAction(ParlPerfectGame* pg, ParlAction a, ParlIdx idxA, ParlIdx idxB, ParlIdx idxC);
+
+/**
+ * @brief Same as `parlPerfect_applyAction`, but with the action and its arguments packed into a `ParlMove`.
+ */
+bool parlPerfect_applyMove(ParlPerfectGame* pg, ParlMove m);
+
+/**
+ * @brief Plays uniformly random legal moves until the game is over.
+ * @param pg
+ * @param r
+ * @param maxPlies The most moves to play before giving up.
+ * @return The winner, or `PARL_NO_WINNER` if the game didn't end within `maxPlies` moves.
+ */
+ParlPlayer parlPerfect_playout(ParlPerfectGame* pg, ParlRng* r, int maxPlies);
+
+#endif //PARLIAMENT_PERFECT_H
@@ -0,0 +1,608 @@
+/**
+ * @file
+ * @brief Counts every sequence of legal moves from the start of a game up to a given depth, like perft in chess.
+ *
+ * @details
+ * Usage: `parliament_perft [maxDepth] [numPlayers] [numJokers] [myFirstCard]`
+ *
+ * The game is set up with `parlGame_init` from the known player's point of view, with the known player in position 0.
+ * For each depth from 1 to `maxDepth`, the whole tree is walked with `parlGame_generateMoves` and
+ * `parlGame_applyMoveUndoable`, and the number of positions at that depth is printed along with how fast they were
+ * reached. Since the counts only depend on the rules, they can be compared before and after a change to game.c to
+ * check that it didn't change which moves are legal.
+ *
+ * Along the way, every generated move is checked against `parlGame_legalActions`, every legal action outside of
+ * `PARL_PERFT_MAY_BE_MISSING` is checked to have a move, every position's incrementally updated hash is checked against
+ * `parlZobrist_hash`, and every position is checked to be exactly the same after its moves are undone. Afterwards,
+ * random full-information games with the same number of players and jokers are played through a `ParlGameBatch` and
+ * one at a time side by side, to check that batch.h follows the same rules, and that their legal actions have moves
+ * too, and every state they pass through is packed and unpacked with record.h. More random games check that
+ * `parlGame_resolveImpeachment` agrees with playing each impeachment move by move, and that a log of games, including
+ * one cut short, reads back and replays the same as what was written. The program exits with 1 if any check fails.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "batch.h"
+#include "game.h"
+#include "record.h"
+#include "replay.h"
+#include "timer.h"
+#include "zobrist.h"
+
+/**
+ * The number of games played side by side by `parlPerft_checkBatch`.
+ */
+#define PARL_PERFT_BATCH_GAMES 256
+
+/**
+ * The number of moves played in each game by `parlPerft_checkBatch`. Games that end are started over.
+ */
+#define PARL_PERFT_BATCH_PLIES 1000
+
+/**
+ * The number of games played by `parlPerft_checkImpeachment`, each for at most `PARL_PERFT_BATCH_PLIES` moves.
+ */
+#define PARL_PERFT_IMPEACHMENT_GAMES 256
+
+/**
+ * The number of games written to the log by `parlPerft_checkLog`, each for at most `PARL_PERFT_BATCH_PLIES` moves.
+ */
+#define PARL_PERFT_LOG_GAMES 8
+
+/**
+ * The log file written by `parlPerft_checkLog`, in the working directory. It's deleted afterwards.
+ */
+#define PARL_PERFT_LOG_PATH "parliament_perft.log"
+
+/**
+ * The number of moves between the copies of the state kept by the replays in `parlPerft_checkLog`.
+ */
+#define PARL_PERFT_REPLAY_INTERVAL 7
+
+/**
+ * The actions that `parlGame_legalActions` can have without any moves from `parlGame_generateMoves`. See its notes.
+ */
+#define PARL_PERFT_MAY_BE_MISSING ( \
+    1u << CALL_ELECTION | 1u << VOTE_NO_CONF | 1u << IMPEACH_PM \
+    | 1u << REIMPEACH | 1u << BLOCK_IMPEACH | 1u << CONTEST_ELECTION \
+    | 1u << ENDGAME_TRY_FORMATION | 1u << ENDGAME_BLOCK_COALITION | 1u << ENDGAME_COUNTER_BLOCK_COALITION \
+)
+
+/**
+ * Counts from the walk that aren't positions.
+ */
+typedef struct ParlPerftStats
+{
+    /**
+     * The number of moves generated but not in `parlGame_legalActions`, or not accepted when applied.
+     */
+    unsigned long illegalMoves;
+
+    /**
+     * The number of positions with an action in `parlGame_legalActions` but no move for it, other than those in
+     * `PARL_PERFT_MAY_BE_MISSING`.
+     */
+    unsigned long missingMoves;
+
+    /**
+     * The number of positions that weren't the same after undoing all of their moves.
+     */
+    unsigned long badUndos;
+
+    /**
+     * The number of positions whose `hash` wasn't the same as hashing them from scratch.
+     */
+    unsigned long badHashes;
+
+    /**
+     * The number of times a `ParlGameBatch` didn't have the same legal actions, result, or game afterwards as playing
+     * the same game on its own.
+     */
+    unsigned long badBatches;
+
+    /**
+     * The number of times `parlGame_resolveImpeachment` didn't leave a game the same as playing out its impeachment
+     * move by move.
+     */
+    unsigned long badImpeachments;
+
+    /**
+     * The number of times a packed state, a log, or a replay didn't give back what was put into it.
+     */
+    unsigned long badRecords;
+} ParlPerftStats;
+
+/**
+ * @brief Counts a missing move in `stats` if some action in `legal` has none of `moves`, other than those in
+ * `PARL_PERFT_MAY_BE_MISSING`.
+ * @param legal
+ * @param moves
+ * @param numMoves
+ * @param stats
+ */
+static void parlPerft_checkMissing(const unsigned int legal,
+                                   const ParlMove* const moves,
+                                   const int numMoves,
+                                   ParlPerftStats* const stats)
+{
+    register unsigned int generated = 0;
+
+    for(register int i = 0; i < numMoves; ++i)
+        generated |= 1u << moves[i].action;
+
+    if(legal & ~generated & ~PARL_PERFT_MAY_BE_MISSING)
+        ++stats->missingMoves;
+}
+
+/**
+ * @brief Counts the positions exactly `depth` moves after `g`.
+ * @param g The position to walk from. It's changed along the way but restored before returning.
+ * @param depth
+ * @param moves One buffer of `PARL_MAX_MOVES` moves for each level of depth.
+ * @param stats Where to count problems found along the way.
+ * @return The number of positions.
+ */
+static unsigned long long parlPerft(ParlGame* const g,
+                                    const int depth,
+                                    ParlMove (* const moves)[PARL_MAX_MOVES],
+                                    ParlPerftStats* const stats)
+{
+    if(depth == 0)
+        return 1;
+
+    const ParlGame before = *g;
+    const register unsigned int legal = parlGame_legalActions(g);
+    register int numMoves = parlGame_generateMoves(g, moves[0], PARL_MAX_MOVES);
+    register unsigned long long nodes = 0;
+    ParlUndo u;
+
+    if(numMoves > PARL_MAX_MOVES)
+        numMoves = PARL_MAX_MOVES;
+
+    parlPerft_checkMissing(legal, moves[0], numMoves, stats);
+
+    for(register int i = 0; i < numMoves; ++i)
+    {
+        if(!(legal & 1u << moves[0][i].action) || !parlGame_applyMoveUndoable(g, &u, moves[0][i]))
+        {
+            ++stats->illegalMoves;
+            continue;
+        }
+
+        if(g->hash != parlZobrist_hash(g))
+            ++stats->badHashes;
+
+        nodes += depth == 1 ? 1 : parlPerft(g, depth - 1, moves + 1, stats);
+        parlGame_undoAction(g, &u);
+    }
+
+    if(memcmp(g, &before, sizeof before) != 0)
+    {
+        ++stats->badUndos;
+        *g = before;
+    }
+
+    return nodes;
+}
+
+/**
+ * @brief Plays random full-information games both through a `ParlGameBatch` and one at a time with perfect.h, and
+ * counts every difference between the two.
+ *
+ * @details
+ * Every move, the batch's legal actions are checked against `parlGame_legalActions`. Then each game plays a random
+ * move. `DRAW`, `DISCARD`, and `APPOINT_MP` go through `parlGameBatch_draw`, `parlGameBatch_discard`, and
+ * `parlGameBatch_appointMp`, sometimes with a card the player might not have, and every other move is played on its
+ * own and put back with `parlGameBatch_set`. Every game in the batch then has to be exactly the same as its copy.
+ *
+ * @param numJokers
+ * @param numPlayers
+ * @param stats
+ */
+static void parlPerft_checkBatch(const int numJokers, const int numPlayers, ParlPerftStats* const stats)
+{
+    static const ParlAction batched[3] = {DRAW, DISCARD, APPOINT_MP};
+    static ParlPerfectGame games[PARL_PERFT_BATCH_GAMES];
+    static unsigned int legal[PARL_PERFT_BATCH_GAMES];
+    static uint8_t lanes[3][PARL_PERFT_BATCH_GAMES];
+    static ParlIdx cards[PARL_PERFT_BATCH_GAMES];
+    static bool ok[PARL_PERFT_BATCH_GAMES], expected[PARL_PERFT_BATCH_GAMES];
+    ParlMove moves[PARL_MAX_MOVES];
+    ParlPackedGame packed;
+    ParlGame unpacked;
+    ParlGameBatch b;
+    ParlRng r;
+
+    if(!parlGameBatch_init(&b, PARL_PERFT_BATCH_GAMES))
+    {
+        ++stats->badBatches;
+        return;
+    }
+
+    parlRng_seed(&r, 1);
+
+    for(register int i = 0; i < PARL_PERFT_BATCH_GAMES; ++i)
+    {
+        if(!parlPerfect_init(&games[i], numJokers, numPlayers, parlRng_next(&r)))
+        {
+            ++stats->badBatches;
+            parlGameBatch_free(&b);
+            return;
+        }
+
+        parlGameBatch_add(&b, &games[i]);
+    }
+
+    for(register int ply = 0; ply < PARL_PERFT_BATCH_PLIES; ++ply)
+    {
+        parlGameBatch_legalActions(&b, legal);
+        memset(lanes, 0, sizeof lanes);
+
+        for(register int i = 0; i < PARL_PERFT_BATCH_GAMES; ++i)
+        {
+            ParlPerfectGame* const pg = &games[i];
+
+            if(legal[i] != parlGame_legalActions(&pg->g))
+                ++stats->badBatches;
+
+            parlRecord_packGame(&pg->g, &packed);
+
+            if(!parlRecord_unpackGame(&packed, &unpacked) || memcmp(&unpacked, &pg->g, sizeof unpacked) != 0)
+                ++stats->badRecords;
+
+            register int numMoves = parlGame_generateMoves(&pg->g, moves, PARL_MAX_MOVES);
+
+            if(!numMoves)
+            {
+                if(!parlPerfect_init(pg, numJokers, numPlayers, parlRng_next(&r)))
+                {
+                    ++stats->badBatches;
+                    parlGameBatch_free(&b);
+                    return;
+                }
+
+                parlGameBatch_set(&b, i, pg);
+                continue;
+            }
+
+            if(numMoves > PARL_MAX_MOVES)
+                numMoves = PARL_MAX_MOVES;
+
+            parlPerft_checkMissing(legal[i], moves, numMoves, stats);
+
+            ParlMove m = moves[parlRng_below(&r, numMoves)];
+            register int kind = 0;
+
+            while(kind < 3 && batched[kind] != m.action)
+                ++kind;
+
+            if(kind == 3)
+            {
+                parlPerfect_applyMove(pg, m);
+                parlGameBatch_set(&b, i, pg);
+                continue;
+            }
+
+            if(m.action != DRAW && parlRng_below(&r, 16) == 0)
+                m.idxA = parlRng_below(&r, PARL_JOKER_IDX + 1);
+
+            lanes[kind][i] = 1;
+            cards[i] = m.idxA;
+
+            // An illegal move may have changed part of the game before it was found to be illegal
+            const ParlPerfectGame before = *pg;
+            if(!(expected[i] = parlPerfect_applyMove(pg, m)))
+                *pg = before;
+        }
+
+        parlGameBatch_draw(&b, lanes[0], ok);
+        parlGameBatch_discard(&b, lanes[1], cards, ok);
+        parlGameBatch_appointMp(&b, lanes[2], cards, ok);
+
+        for(register int i = 0; i < PARL_PERFT_BATCH_GAMES; ++i)
+        {
+            ParlPerfectGame got;
+            parlGameBatch_get(&b, i, &got);
+
+            if(
+                ((lanes[0][i] | lanes[1][i] | lanes[2][i]) && ok[i] != expected[i])
+                || memcmp(&got, &games[i], sizeof got) != 0
+            )
+            {
+                ++stats->badBatches;
+                parlGameBatch_set(&b, i, &games[i]);
+            }
+        }
+    }
+
+    parlGameBatch_free(&b);
+}
+
+/**
+ * @brief Plays random full-information games, resolving each impeachment both with `parlGame_resolveImpeachment` and
+ * move by move, and counts every difference between the two.
+ *
+ * @details
+ * Before every move, a copy of the game is resolved in one step with a random set of raisers: nobody, everybody, or
+ * each player by chance. Another copy plays the same impeachment with `parlGame_generateMoves`, where each raiser plays
+ * the first block or re-impeachment listed, which is their lowest card that can, and everyone else passes. The two
+ * copies have to be exactly the same, hash included, which also means that `parlGame_resolveImpeachment` has to leave a
+ * game that isn't in an impeachment alone.
+ *
+ * @param numJokers
+ * @param numPlayers
+ * @param stats
+ */
+static void parlPerft_checkImpeachment(const int numJokers, const int numPlayers, ParlPerftStats* const stats)
+{
+    ParlMove moves[PARL_MAX_MOVES];
+    ParlPerfectGame pg;
+    ParlRng r;
+
+    parlRng_seed(&r, 2);
+
+    for(register int game = 0; game < PARL_PERFT_IMPEACHMENT_GAMES; ++game)
+    {
+        if(!parlPerfect_init(&pg, numJokers, numPlayers, parlRng_next(&r)))
+        {
+            ++stats->badImpeachments;
+            return;
+        }
+
+        for(register int ply = 0; ply < PARL_PERFT_BATCH_PLIES; ++ply)
+        {
+            const register int kind = parlRng_below(&r, 3);
+            const register unsigned int raisers = kind == 0 ? 0 : kind == 1 ? ~0u : (unsigned int)parlRng_next(&r);
+            const register bool impeaching = pg.g.mode == BLOCK_IMPEACH_MODE || pg.g.mode == REIMPEACH_MODE;
+            ParlGame resolved = pg.g, stepped = pg.g;
+
+            if(parlGame_resolveImpeachment(&resolved, raisers) != impeaching)
+                ++stats->badImpeachments;
+
+            while(stepped.mode == BLOCK_IMPEACH_MODE || stepped.mode == REIMPEACH_MODE)
+            {
+                // The raises are listed first from the lowest card up, and passing is always last
+                const register int numMoves = parlGame_generateMoves(&stepped, moves, PARL_MAX_MOVES);
+
+                if(!parlGame_applyMove(&stepped, moves[raisers & 1u << stepped.turn ? 0 : numMoves - 1]))
+                {
+                    ++stats->badImpeachments;
+                    break;
+                }
+            }
+
+            if(memcmp(&resolved, &stepped, sizeof stepped) != 0 || resolved.hash != parlZobrist_hash(&resolved))
+                ++stats->badImpeachments;
+
+            register int numMoves = parlGame_generateMoves(&pg.g, moves, PARL_MAX_MOVES);
+
+            if(!numMoves)
+                break;
+            if(numMoves > PARL_MAX_MOVES)
+                numMoves = PARL_MAX_MOVES;
+
+            parlPerfect_applyMove(&pg, moves[parlRng_below(&r, numMoves)]);
+        }
+    }
+}
+
+/**
+ * @brief Writes random full-information games to a log, and counts every difference between what was written and what
+ * is read back.
+ *
+ * @details
+ * Half of the games are written, and then half of another entry is tacked on, as if the writer had been killed. The
+ * log is opened again, which has to cut the partial entry off, and the rest of the games are written. Reading the log
+ * back then has to give every game exactly as it was written, and nothing else. Each game is also replayed, and
+ * `parlReplay_seek` has to give the same state after every number of moves as applying them one at a time.
+ *
+ * @param numJokers
+ * @param numPlayers
+ * @param stats
+ */
+static void parlPerft_checkLog(const int numJokers, const int numPlayers, ParlPerftStats* const stats)
+{
+    static ParlGame starts[PARL_PERFT_LOG_GAMES];
+    static ParlMove played[PARL_PERFT_LOG_GAMES][PARL_PERFT_BATCH_PLIES];
+    static uint32_t numPlayed[PARL_PERFT_LOG_GAMES];
+    ParlMove moves[PARL_MAX_MOVES];
+    ParlPerfectGame pg;
+    ParlRecordWriter w;
+    ParlRecordLog log;
+    ParlRecordEntry e;
+    ParlReplay replay;
+    ParlPackedGame packed;
+    ParlGame unpacked, sought;
+    ParlRng r;
+
+    parlRng_seed(&r, 3);
+    remove(PARL_PERFT_LOG_PATH);
+
+    for(register int game = 0; game < PARL_PERFT_LOG_GAMES; ++game)
+    {
+        if(!parlPerfect_init(&pg, numJokers, numPlayers, parlRng_next(&r)))
+        {
+            ++stats->badRecords;
+            return;
+        }
+
+        starts[game] = pg.g;
+        numPlayed[game] = 0;
+
+        while(numPlayed[game] < PARL_PERFT_BATCH_PLIES)
+        {
+            register int numMoves = parlGame_generateMoves(&pg.g, moves, PARL_MAX_MOVES);
+
+            if(!numMoves)
+                break;
+            if(numMoves > PARL_MAX_MOVES)
+                numMoves = PARL_MAX_MOVES;
+
+            const ParlMove m = moves[parlRng_below(&r, numMoves)];
+            ParlMove* const record = &played[game][numPlayed[game]++];
+
+            // Record a draw as the card that comes off the top, which is how `parlPerfect_applyAction` applies it
+            *record = m.action == DRAW
+                ? (ParlMove){SELF_DRAW, pg.drawDeck[pg.g.drawDeckSize - 1], PARL_NO_ARG, PARL_NO_ARG}
+                : m;
+
+            parlPerfect_applyMove(&pg, m);
+        }
+    }
+
+    for(register int game = 0; game < PARL_PERFT_LOG_GAMES; ++game)
+    {
+        if(game == 0 || game == PARL_PERFT_LOG_GAMES / 2)
+        {
+            if(game)
+            {
+                parlRecordWriter_close(&w);
+
+#if defined(__unix__) || defined(__APPLE__)
+                // Half of an entry, for the writer to cut off. Only where record.c can truncate files
+                FILE* const file = fopen(PARL_PERFT_LOG_PATH, "ab");
+                const ParlRecordEntryHeader h = {sizeof h + sizeof packed, 0};
+
+                parlRecord_packGame(&starts[0], &packed);
+
+                if(file == NULL
+                    || fwrite(&h, sizeof h, 1, file) != 1
+                    || fwrite(&packed, sizeof packed / 2, 1, file) != 1
+                    || fclose(file) != 0)
+                    ++stats->badRecords;
+#endif
+            }
+
+            if(!parlRecordWriter_open(&w, PARL_PERFT_LOG_PATH))
+            {
+                ++stats->badRecords;
+                remove(PARL_PERFT_LOG_PATH);
+                return;
+            }
+        }
+
+        if(!parlRecordWriter_add(&w, &starts[game], played[game], numPlayed[game]))
+            ++stats->badRecords;
+    }
+
+    parlRecordWriter_close(&w);
+
+    if(!parlRecordLog_open(&log, PARL_PERFT_LOG_PATH))
+    {
+        ++stats->badRecords;
+        remove(PARL_PERFT_LOG_PATH);
+        return;
+    }
+
+    size_t offset = sizeof(ParlRecordFileHeader);
+
+    for(register int game = 0; game < PARL_PERFT_LOG_GAMES; ++game)
+    {
+        if(!parlRecordLog_next(&log, &offset, &e)
+            || !parlRecord_unpackGame(e.start, &unpacked)
+            || memcmp(&unpacked, &starts[game], sizeof unpacked) != 0
+            || e.numMoves != numPlayed[game])
+        {
+            ++stats->badRecords;
+            break;
+        }
+
+        for(register uint32_t n = 0; n < e.numMoves; ++n)
+        {
+            const ParlMove m = parlRecord_unpackMove(e.moves[n]);
+
+            if(m.action != played[game][n].action
+                || m.idxA != played[game][n].idxA
+                || m.idxB != played[game][n].idxB
+                || m.idxC != played[game][n].idxC)
+                ++stats->badRecords;
+        }
+
+        if(!parlReplay_init(&replay, &e, PARL_PERFT_REPLAY_INTERVAL) || replay.numMoves != e.numMoves)
+        {
+            ++stats->badRecords;
+            parlReplay_free(&replay);
+            continue;
+        }
+
+        // `unpacked` follows along one move at a time
+        for(register uint32_t n = 0;; ++n)
+        {
+            if(!parlReplay_seek(&replay, n, &sought) || memcmp(&sought, &unpacked, sizeof sought) != 0)
+                ++stats->badRecords;
+
+            if(n == e.numMoves)
+                break;
+
+            const ParlMove m = played[game][n];
+            parlGame_applyAction(&unpacked, m.action, m.idxA, m.idxB, m.idxC);
+        }
+
+        if(parlReplay_seek(&replay, e.numMoves + 1, &sought))
+            ++stats->badRecords;
+
+        parlReplay_free(&replay);
+    }
+
+    // The partial entry has to be gone, leaving nothing after the last game
+    if(parlRecordLog_next(&log, &offset, &e) || offset != log.size)
+        ++stats->badRecords;
+
+    parlRecordLog_close(&log);
+    remove(PARL_PERFT_LOG_PATH);
+}
+
+int main(const int argc, const char* const argv[])
+{
+    const int maxDepth = argc > 1 ? atoi(argv[1]) : 3,
+        numPlayers = argc > 2 ? atoi(argv[2]) : 4,
+        numJokers = argc > 3 ? atoi(argv[3]) : 2;
+    const ParlIdx myFirstCard = parlSymbolToIdx(argc > 4 ? argv[4] : "3h");
+    ParlPerftStats stats = {0, 0, 0, 0, 0, 0, 0};
+    ParlGame g;
+    ParlTimer t;
+
+    if(maxDepth < 1 || !parlGame_init(&g, numJokers, numPlayers, 0, myFirstCard))
+    {
+        fprintf(stderr, "usage: %s [maxDepth] [numPlayers] [numJokers] [myFirstCard]\n", argv[0]);
+        return 1;
+    }
+
+    ParlMove (* const moves)[PARL_MAX_MOVES] = malloc(maxDepth * sizeof *moves);
+    if(!moves)
+        return 1;
+
+    printf("%5s %16s %12s %14s\n", "depth", "nodes", "ms", "nodes/s");
+
+    for(int depth = 1; depth <= maxDepth; ++depth)
+    {
+        parlTimer_start(&t);
+        const unsigned long long nodes = parlPerft(&g, depth, moves, &stats);
+        parlTimer_stop(&t);
+
+        const double secs = parlTimer_secs(&t);
+        printf("%5i %16llu %12.1f %14.0f\n", depth, nodes, 1000 * secs, secs > 0 ? nodes / secs : 0);
+        fflush(stdout);
+    }
+
+    free(moves);
+    parlPerft_checkBatch(numJokers, numPlayers, &stats);
+    parlPerft_checkImpeachment(numJokers, numPlayers, &stats);
+    parlPerft_checkLog(numJokers, numPlayers, &stats);
+
+    if(stats.illegalMoves || stats.missingMoves || stats.badUndos || stats.badHashes || stats.badBatches
+        || stats.badImpeachments || stats.badRecords)
+    {
+        printf("%lu illegal moves generated, %lu positions with legal actions but no moves, "
+               "%lu positions not restored by undo, %lu wrong hashes, %lu batch differences, "
+               "%lu impeachment differences, %lu record differences\n",
+               stats.illegalMoves, stats.missingMoves, stats.badUndos, stats.badHashes, stats.badBatches,
+               stats.badImpeachments, stats.badRecords);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,457 @@
+// For mmap, open, fstat, ftruncate and fileno when compiling without GNU extensions
+#define _POSIX_C_SOURCE 200809L
+
+#include "record.h"
+#include "zobrist.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define PARL_RECORD_MMAP 1
+#else
+#define PARL_RECORD_MMAP 0
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define parlRecord_le64(x) __builtin_bswap64(x)
+#define parlRecord_le32(x) __builtin_bswap32(x)
+#else
+#define parlRecord_le64(x) (x)
+#define parlRecord_le32(x) (x)
+#endif
+
+/**
+ * @param n
+ * @return `n` rounded up to a multiple of 8.
+ */
+#define PARL_RECORD_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+/**
+ * @param numMoves
+ * @return The number of bytes in a log entry with `numMoves` moves.
+ */
+#define PARL_RECORD_ENTRY_SIZE(numMoves) PARL_RECORD_ALIGN(sizeof(ParlRecordEntryHeader) \
+    + sizeof(ParlPackedGame) + (size_t)(numMoves) * sizeof(ParlPackedMove))
+
+/**
+ * @brief Writes the low `width` bits of `value` at bit `*pos` of `words`, and moves `*pos` past them.
+ */
+static void parlRecord_putBits(uint64_t* const words, int* const pos, const uint64_t value, const int width)
+{
+    const register uint64_t v = value & ((1ull << width) - 1);
+    const register int word = *pos / 64, bit = *pos % 64;
+
+    words[word] |= v << bit;
+    if(bit + width > 64)
+        words[word + 1] |= v >> (64 - bit);
+
+    *pos += width;
+}
+
+/**
+ * @return The `width` bits at bit `*pos` of `words`, after which `*pos` is moved past them.
+ */
+static uint64_t parlRecord_getBits(const uint64_t* const words, int* const pos, const int width)
+{
+    const register int word = *pos / 64, bit = *pos % 64;
+    register uint64_t v = words[word] >> bit;
+
+    if(bit + width > 64)
+        v |= words[word + 1] << (64 - bit);
+
+    *pos += width;
+    return v & ((1ull << width) - 1);
+}
+
+/**
+ * @return The `PARL_PLAYER_WIDTH` bits at bit `*pos` of `words` as a player, which can be negative like `PARL_NO_PM`.
+ */
+static ParlPlayer parlRecord_getPlayer(const uint64_t* const words, int* const pos)
+{
+    const register ParlPlayer p = (ParlPlayer)parlRecord_getBits(words, pos, PARL_PLAYER_WIDTH);
+    return p >= 1 << (PARL_PLAYER_WIDTH - 1) ? p - (1 << PARL_PLAYER_WIDTH) : p;
+}
+
+void parlRecord_packGame(const ParlGame* const g, ParlPackedGame* const out)
+{
+    register uint64_t* const w = out->words;
+    int pos = 0;
+
+    memset(out, 0, sizeof(ParlPackedGame));
+
+    parlRecord_putBits(w, &pos, PARL_RECORD_VERSION, 8);
+    parlRecord_putBits(w, &pos, g->numPlayers, PARL_PLAYER_WIDTH + 1);
+    parlRecord_putBits(w, &pos, g->myPosition, PARL_PLAYER_WIDTH);
+    parlRecord_putBits(w, &pos, g->allHandsKnown, 1);
+    parlRecord_putBits(w, &pos, g->turn, PARL_PLAYER_WIDTH);
+    parlRecord_putBits(w, &pos, g->pmPosition, PARL_PLAYER_WIDTH);
+    parlRecord_putBits(w, &pos, g->pmCardIdx, PARL_IDX_WIDTH);
+    parlRecord_putBits(w, &pos, g->drawDeckSize, 6);
+    parlRecord_putBits(w, &pos, g->mode, 4);
+    parlRecord_putBits(w, &pos, g->coalitionSize, 6);
+    parlRecord_putBits(w, &pos, g->endgameSkipPm, 1);
+    parlRecord_putBits(w, &pos, g->currNormalTurn, PARL_PLAYER_WIDTH);
+    parlRecord_putBits(w, &pos, g->cardToBeatIdx, PARL_IDX_WIDTH);
+    parlRecord_putBits(w, &pos, g->impeachedMpIdx, PARL_IDX_WIDTH);
+    parlRecord_putBits(w, &pos, g->cycleStarter, PARL_PLAYER_WIDTH);
+
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+        parlRecord_putBits(w, &pos, (uint8_t)g->handSizes[p], 8);
+
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+    {
+        parlRecord_putBits(w, &pos, g->elecCands[p].pmIdx, PARL_IDX_WIDTH);
+        parlRecord_putBits(w, &pos, g->elecCands[p].preCallNumCards, PARL_IDX_WIDTH);
+    }
+
+    register uint64_t* stacks = w + PARL_RECORD_SCALAR_WORDS;
+    *stacks++ = g->cabinet;
+    *stacks++ = g->parliament;
+    *stacks++ = g->discard;
+    *stacks++ = g->faceDownCards;
+
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+        *stacks++ = g->knownHands[p];
+
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+        *stacks++ = g->elecCands[p].callingCards;
+
+    for(register int i = 0; i < PARL_RECORD_GAME_WORDS; ++i)
+        w[i] = parlRecord_le64(w[i]);
+}
+
+bool parlRecord_unpackGame(const ParlPackedGame* const in, ParlGame* const out)
+{
+    uint64_t w[PARL_RECORD_GAME_WORDS];
+    ParlGame g = {0};
+    int pos = 0;
+
+    for(register int i = 0; i < PARL_RECORD_GAME_WORDS; ++i)
+        w[i] = parlRecord_le64(in->words[i]);
+
+    if(parlRecord_getBits(w, &pos, 8) != PARL_RECORD_VERSION)
+        return false;
+
+    g.numPlayers = (ParlPlayer)parlRecord_getBits(w, &pos, PARL_PLAYER_WIDTH + 1);
+    g.myPosition = parlRecord_getPlayer(w, &pos);
+    g.allHandsKnown = parlRecord_getBits(w, &pos, 1);
+    g.turn = parlRecord_getPlayer(w, &pos);
+    g.pmPosition = parlRecord_getPlayer(w, &pos);
+    g.pmCardIdx = parlRecord_getBits(w, &pos, PARL_IDX_WIDTH);
+    g.drawDeckSize = parlRecord_getBits(w, &pos, 6);
+    g.mode = parlRecord_getBits(w, &pos, 4);
+    g.coalitionSize = parlRecord_getBits(w, &pos, 6);
+    g.endgameSkipPm = parlRecord_getBits(w, &pos, 1);
+    g.currNormalTurn = parlRecord_getPlayer(w, &pos);
+    g.cardToBeatIdx = parlRecord_getBits(w, &pos, PARL_IDX_WIDTH);
+    g.impeachedMpIdx = parlRecord_getBits(w, &pos, PARL_IDX_WIDTH);
+    g.cycleStarter = parlRecord_getPlayer(w, &pos);
+
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+        g.handSizes[p] = (int8_t)parlRecord_getBits(w, &pos, 8);
+
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+    {
+        g.elecCands[p].pmIdx = parlRecord_getBits(w, &pos, PARL_IDX_WIDTH);
+        g.elecCands[p].preCallNumCards = parlRecord_getBits(w, &pos, PARL_IDX_WIDTH);
+    }
+
+    const register uint64_t* stacks = w + PARL_RECORD_SCALAR_WORDS;
+    g.cabinet = *stacks++;
+    g.parliament = *stacks++;
+    g.discard = *stacks++;
+    g.faceDownCards = *stacks++;
+
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+        g.knownHands[p] = *stacks++;
+
+    for(register int p = 0; p < PARL_MAX_NUM_PLAYERS; ++p)
+        g.elecCands[p].callingCards = *stacks++;
+
+    if(g.numPlayers < 1 || g.numPlayers > PARL_MAX_NUM_PLAYERS
+        || g.myPosition < 0 || g.myPosition >= g.numPlayers
+        || g.turn < 0 || g.turn >= g.numPlayers
+        || g.pmPosition >= g.numPlayers
+        || g.mode > GAME_OVER)
+        return false;
+
+    parlGame_recountParliament(&g);
+    g.hash = parlZobrist_hash(&g);
+    *out = g;
+    return true;
+}
+
+ParlPackedMove parlRecord_packMove(const ParlMove m)
+{
+    return (ParlPackedMove){
+        .action = m.action,
+        .idxA = m.idxA,
+        .idxB = m.idxB,
+        .idxC = m.idxC
+    };
+}
+
+ParlMove parlRecord_unpackMove(const ParlPackedMove m)
+{
+    return (ParlMove){
+        .action = m.action,
+        .idxA = m.idxA,
+        .idxB = m.idxB,
+        .idxC = m.idxC
+    };
+}
+
+/**
+ * @return Whether `h` is the header of a log that this version can read.
+ */
+static bool parlRecord_validHeader(const ParlRecordFileHeader* const h)
+{
+    return memcmp(h->magic, PARL_RECORD_MAGIC, sizeof(h->magic)) == 0
+        && parlRecord_le32(h->version) == PARL_RECORD_VERSION
+        && parlRecord_le32(h->gameWords) == PARL_RECORD_GAME_WORDS;
+}
+
+/**
+ * @brief Walks the entries of a log from the first one by reading only their headers.
+ * @param file An open log whose header has been checked.
+ * @param fileSize
+ * @return Where the last whole entry ends, which is `fileSize` unless the log ends in a partial entry, or 0 if the file
+ * couldn't be read.
+ */
+static long parlRecord_logEnd(FILE* const file, const long fileSize)
+{
+    register long end = sizeof(ParlRecordFileHeader);
+    ParlRecordEntryHeader h;
+
+    while(fileSize - end >= (long)sizeof h)
+    {
+        if(fseek(file, end, SEEK_SET) != 0 || fread(&h, sizeof h, 1, file) != 1)
+            return 0;
+
+        const register size_t size = parlRecord_le32(h.size);
+
+        // The same checks as `parlRecordLog_next`, which stops reading at the first entry that fails them
+        if(size != PARL_RECORD_ENTRY_SIZE(parlRecord_le32(h.numMoves)) || (size_t)(fileSize - end) < size)
+            break;
+
+        end += size;
+    }
+
+    return end;
+}
+
+bool parlRecordWriter_open(ParlRecordWriter* const w, const char* const path)
+{
+    *w = (ParlRecordWriter){
+        .file = fopen(path, "a+b")
+    };
+
+    if(w->file == NULL)
+        return false;
+
+    ParlRecordFileHeader h;
+
+    register long fileSize;
+
+    if(fseek(w->file, 0, SEEK_END) != 0 || (fileSize = ftell(w->file)) < 0)
+        goto fail;
+
+    if(fileSize == 0)
+    {
+        memcpy(h.magic, PARL_RECORD_MAGIC, sizeof(h.magic));
+        h.version = parlRecord_le32(PARL_RECORD_VERSION);
+        h.gameWords = parlRecord_le32(PARL_RECORD_GAME_WORDS);
+
+        if(fwrite(&h, sizeof h, 1, w->file) != 1 || fflush(w->file) != 0)
+            goto fail;
+    }
+    else
+    {
+        if(fseek(w->file, 0, SEEK_SET) != 0
+            || fread(&h, sizeof h, 1, w->file) != 1
+            || !parlRecord_validHeader(&h))
+            goto fail;
+
+        const register long end = parlRecord_logEnd(w->file, fileSize);
+
+        if(end == 0)
+            goto fail;
+
+        // Appending after a partial entry would hide every entry from then on from `parlRecordLog_next`
+        if(end < fileSize)
+        {
+#if PARL_RECORD_MMAP
+            if(ftruncate(fileno(w->file), end) != 0)
+                goto fail;
+#else
+            goto fail;
+#endif
+        }
+
+        // Switch the stream from reading back to writing
+        if(fseek(w->file, 0, SEEK_END) != 0)
+            goto fail;
+    }
+
+    return true;
+
+fail:
+    fclose(w->file);
+    w->file = NULL;
+    return false;
+}
+
+void parlRecordWriter_close(ParlRecordWriter* const w)
+{
+    if(w->file != NULL)
+        fclose(w->file);
+
+    free(w->buffer);
+    *w = (ParlRecordWriter){0};
+}
+
+bool parlRecordWriter_add(ParlRecordWriter* const w,
+                          const ParlGame* const start,
+                          const ParlMove* const moves,
+                          const uint32_t numMoves)
+{
+    const register size_t size = PARL_RECORD_ENTRY_SIZE(numMoves);
+
+    if(size > UINT32_MAX)
+        return false;
+
+    if(size > w->capacity)
+    {
+        unsigned char* const buffer = realloc(w->buffer, size);
+
+        if(buffer == NULL)
+            return false;
+
+        w->buffer = buffer;
+        w->capacity = size;
+    }
+
+    memset(w->buffer, 0, size);
+
+    const ParlRecordEntryHeader h = {
+        .size = parlRecord_le32((uint32_t)size),
+        .numMoves = parlRecord_le32(numMoves)
+    };
+    memcpy(w->buffer, &h, sizeof h);
+
+    ParlPackedGame packed;
+    parlRecord_packGame(start, &packed);
+    memcpy(w->buffer + sizeof h, &packed, sizeof packed);
+
+    register ParlPackedMove* const packedMoves = (ParlPackedMove*)(w->buffer + sizeof h + sizeof packed);
+    for(register uint32_t i = 0; i < numMoves; ++i)
+        packedMoves[i] = parlRecord_packMove(moves[i]);
+
+    return fwrite(w->buffer, size, 1, w->file) == 1 && fflush(w->file) == 0;
+}
+
+bool parlRecordLog_open(ParlRecordLog* const log, const char* const path)
+{
+    *log = (ParlRecordLog){0};
+
+#if PARL_RECORD_MMAP
+    const int fd = open(path, O_RDONLY);
+    struct stat st;
+
+    if(fd < 0)
+        return false;
+
+    if(fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ParlRecordFileHeader))
+    {
+        close(fd);
+        return false;
+    }
+
+    void* const data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(data == MAP_FAILED)
+        return false;
+
+    log->data = data;
+    log->size = st.st_size;
+    log->mapped = true;
+#else
+    FILE* const file = fopen(path, "rb");
+
+    if(file == NULL)
+        return false;
+
+    register long size;
+    register unsigned char* data = NULL;
+
+    if(fseek(file, 0, SEEK_END) != 0
+        || (size = ftell(file)) < (long)sizeof(ParlRecordFileHeader)
+        || fseek(file, 0, SEEK_SET) != 0
+        || (data = malloc(size)) == NULL
+        || fread(data, size, 1, file) != 1)
+    {
+        free(data);
+        fclose(file);
+        return false;
+    }
+
+    fclose(file);
+    log->data = data;
+    log->size = size;
+#endif
+
+    ParlRecordFileHeader h;
+    memcpy(&h, log->data, sizeof h);
+
+    if(!parlRecord_validHeader(&h))
+    {
+        parlRecordLog_close(log);
+        return false;
+    }
+
+    return true;
+}
+
+void parlRecordLog_close(ParlRecordLog* const log)
+{
+#if PARL_RECORD_MMAP
+    if(log->mapped)
+        munmap((void*)log->data, log->size);
+    else
+#endif
+        free((void*)log->data);
+
+    *log = (ParlRecordLog){0};
+}
+
+bool parlRecordLog_next(const ParlRecordLog* const log, size_t* const offset, ParlRecordEntry* const out)
+{
+    ParlRecordEntryHeader h;
+
+    if(*offset % 8 != 0 || *offset > log->size || log->size - *offset < sizeof h + sizeof(ParlPackedGame))
+        return false;
+
+    memcpy(&h, log->data + *offset, sizeof h);
+
+    const register uint32_t numMoves = parlRecord_le32(h.numMoves);
+    const register size_t size = parlRecord_le32(h.size);
+
+    if(size != PARL_RECORD_ENTRY_SIZE(numMoves) || log->size - *offset < size)
+        return false;
+
+    const register unsigned char* const entry = log->data + *offset;
+    *out = (ParlRecordEntry){
+        .start = (const ParlPackedGame*)(entry + sizeof h),
+        .moves = (const ParlPackedMove*)(entry + sizeof h + sizeof(ParlPackedGame)),
+        .numMoves = numMoves
+    };
+
+    *offset += size;
+    return true;
+}
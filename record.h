@@ -0,0 +1,230 @@
+/**
+ * @file
+ * @brief A versioned binary encoding of `ParlGame` states and moves, and an append-only log of recorded games that can
+ * be read in place.
+ *
+ * @details
+ * A state packs into `PARL_RECORD_GAME_WORDS` 64-bit words. The scalar fields of `ParlGame` come first, bit-packed at
+ * the same widths as its bitfields, followed by one word per stack. A move packs into 4 bytes, one each for the action
+ * and its three arguments. Both are fixed-width so that any state or move in a buffer of them can be found by its
+ * index. Everything is little-endian no matter the host, and `PARL_RECORD_VERSION` changes whenever the layout does.
+ *
+ * A log file starts with a `ParlRecordFileHeader` and is followed by one entry per game. Each entry is a
+ * `ParlRecordEntryHeader`, the packed state the game started from, and then its moves, padded to a multiple of 8
+ * bytes. `ParlRecordWriter` only ever appends whole entries. `ParlRecordLog` maps the file into memory, and
+ * `parlRecordLog_next` points straight into the mapping instead of copying anything out. An entry that was cut short,
+ * for example because the writer was killed, ends the log, so the next `ParlRecordWriter` to open it cuts that entry
+ * off before appending anything.
+ */
+
+#ifndef PARLIAMENT_RECORD_H
+#define PARLIAMENT_RECORD_H
+
+#include "game.h"
+
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * The version of the layout of packed states, packed moves, and log files.
+ */
+#define PARL_RECORD_VERSION 1
+
+/**
+ * The bytes that every log file starts with.
+ */
+#define PARL_RECORD_MAGIC "PARLREC"
+
+/**
+ * The number of words that the scalar fields of a packed state take up.
+ */
+#define PARL_RECORD_SCALAR_WORDS 7
+
+/**
+ * The number of words in a packed state: the scalar fields, then `cabinet`, `parliament`, `discard`, and
+ * `faceDownCards`, then every player's `knownHands`, then every player's election calling cards.
+ */
+#define PARL_RECORD_GAME_WORDS (PARL_RECORD_SCALAR_WORDS + 4 + 2 * PARL_MAX_NUM_PLAYERS)
+
+/**
+ * @brief A `ParlGame` packed by `parlRecord_packGame`.
+ */
+typedef struct ParlPackedGame
+{
+    uint64_t words[PARL_RECORD_GAME_WORDS];
+} ParlPackedGame;
+
+/**
+ * @brief A `ParlMove` packed by `parlRecord_packMove`. Unused arguments are 63, like in `ParlMove`.
+ */
+typedef struct ParlPackedMove
+{
+    uint8_t action, idxA, idxB, idxC;
+} ParlPackedMove;
+
+/**
+ * @brief The start of a log file.
+ */
+typedef struct ParlRecordFileHeader
+{
+    /**
+     * `PARL_RECORD_MAGIC`, including its terminating null character.
+     */
+    char magic[8];
+
+    /**
+     * `PARL_RECORD_VERSION` when the file was created.
+     */
+    uint32_t version;
+
+    /**
+     * `PARL_RECORD_GAME_WORDS` when the file was created.
+     */
+    uint32_t gameWords;
+} ParlRecordFileHeader;
+
+/**
+ * @brief The start of each game in a log file.
+ */
+typedef struct ParlRecordEntryHeader
+{
+    /**
+     * The number of bytes in the entry, including this header and padding. Always a multiple of 8.
+     */
+    uint32_t size;
+
+    uint32_t numMoves;
+} ParlRecordEntryHeader;
+
+/**
+ * @brief One game in a log file. Everything points into the log that it was read from.
+ */
+typedef struct ParlRecordEntry
+{
+    /**
+     * The state the game started from. Unpack it with `parlRecord_unpackGame`.
+     */
+    const ParlPackedGame* start;
+
+    /**
+     * Every move of the game in order, starting from `start`.
+     */
+    const ParlPackedMove* moves;
+
+    uint32_t numMoves;
+} ParlRecordEntry;
+
+/**
+ * @brief Appends games to a log file.
+ */
+typedef struct ParlRecordWriter
+{
+    FILE* file;
+
+    /**
+     * Where each entry is put together so that it can be written all at once.
+     */
+    unsigned char* buffer;
+
+    size_t capacity;
+} ParlRecordWriter;
+
+/**
+ * @brief A log file mapped into memory for reading.
+ */
+typedef struct ParlRecordLog
+{
+    /**
+     * The whole file.
+     */
+    const unsigned char* data;
+
+    size_t size;
+
+    /**
+     * Whether `data` is a memory mapping rather than a copy of the file in allocated memory. It's only a copy where
+     * memory mapping isn't available.
+     */
+    bool mapped;
+} ParlRecordLog;
+
+/**
+ * @brief Packs `g` into a fixed number of words. `g->hash` isn't stored, since it can be worked out again.
+ * @param g
+ * @param out
+ */
+void parlRecord_packGame(const ParlGame* g, ParlPackedGame* out);
+
+/**
+ * @brief Unpacks a state packed by `parlRecord_packGame`, and hashes it.
+ * @param in
+ * @param out
+ * @return Whether `in` was packed with this `PARL_RECORD_VERSION` and holds a sensible state. If not, `out` is left
+ * alone.
+ */
+bool parlRecord_unpackGame(const ParlPackedGame* in, ParlGame* out);
+
+/**
+ * @param m
+ * @return `m` packed into 4 bytes.
+ */
+ParlPackedMove parlRecord_packMove(ParlMove m);
+
+/**
+ * @param m
+ * @return The move packed by `parlRecord_packMove`.
+ */
+ParlMove parlRecord_unpackMove(ParlPackedMove m);
+
+/**
+ * @brief Opens a log file for appending, and creates it if it doesn't exist. If the log ends in an entry that was cut
+ * short, the file is truncated to the end of the last whole entry.
+ * @param w
+ * @param path
+ * @return Whether the file could be opened, and if it already existed, whether it is a log of this version. Where the
+ * file can't be truncated, this is also false for a log that ends in a partial entry.
+ */
+bool parlRecordWriter_open(ParlRecordWriter* w, const char* path);
+
+/**
+ * @brief Closes the file and frees the memory allocated for `w`, not including the `ParlRecordWriter` struct itself.
+ * @param w
+ */
+void parlRecordWriter_close(ParlRecordWriter* w);
+
+/**
+ * @brief Appends a game to the end of the log and flushes it.
+ * @param w
+ * @param start The state the game started from.
+ * @param moves Every move of the game in order, as they were passed to `parlGame_applyAction`, so that applying them
+ * to `start` replays the game.
+ * @param numMoves
+ * @return Whether the game was written.
+ */
+bool parlRecordWriter_add(ParlRecordWriter* w, const ParlGame* start, const ParlMove* moves, uint32_t numMoves);
+
+/**
+ * @brief Maps a log file into memory.
+ * @param log
+ * @param path
+ * @return Whether the file could be read and is a log of this version.
+ */
+bool parlRecordLog_open(ParlRecordLog* log, const char* path);
+
+/**
+ * @brief Unmaps the file and frees the memory allocated for `log`, not including the `ParlRecordLog` struct itself.
+ * Every `ParlRecordEntry` read from `log` becomes invalid.
+ * @param log
+ */
+void parlRecordLog_close(ParlRecordLog* log);
+
+/**
+ * @brief Reads the game at `*offset` and moves `*offset` to the next one.
+ * @param log
+ * @param offset Where in the file the game starts. Start at `sizeof(ParlRecordFileHeader)` for the first game.
+ * @param out
+ * @return Whether there was a whole game at `*offset`. If not, `*offset` and `out` are left alone.
+ */
+bool parlRecordLog_next(const ParlRecordLog* log, size_t* offset, ParlRecordEntry* out);
+
+#endif //PARLIAMENT_RECORD_H
@@ -0,0 +1,81 @@
+#include "replay.h"
+
+#include <stdlib.h>
+
+/**
+ * @return Whether `m` is legal in `g` and was applied. If not, `g` may have been partly changed.
+ */
+static bool parlReplay_apply(ParlGame* const g, const ParlMove m)
+{
+    register unsigned int legal = parlGame_legalActions(g);
+
+    // When every hand is known, the card drawn is too, so it is recorded like parlPerfect_applyAction applies it
+    if(g->allHandsKnown && legal & 1u << DRAW)
+        legal |= 1u << SELF_DRAW;
+
+    return m.action < 32
+        && legal & 1u << m.action
+        && parlGame_applyAction(g, m.action, m.idxA, m.idxB, m.idxC);
+}
+
+bool parlReplay_init(ParlReplay* const r, const ParlRecordEntry* const e, const uint32_t interval)
+{
+    ParlGame g;
+
+    *r = (ParlReplay){
+        .moves = e->moves,
+        .numRecordedMoves = e->numMoves,
+        .interval = interval
+    };
+
+    if(!interval || !parlRecord_unpackGame(e->start, &g))
+        return false;
+
+    r->checkpoints = malloc((e->numMoves / interval + 1) * sizeof(ParlGame));
+
+    if(r->checkpoints == NULL)
+        return false;
+
+    register uint32_t n = 0;
+
+    for(;; ++n)
+    {
+        if(n % interval == 0)
+            r->checkpoints[n / interval] = g;
+
+        if(n == e->numMoves || !parlReplay_apply(&g, parlReplay_move(r, n)))
+            break;
+    }
+
+    r->numMoves = n;
+    return true;
+}
+
+void parlReplay_free(ParlReplay* const r)
+{
+    free(r->checkpoints);
+    r->checkpoints = NULL;
+}
+
+ParlMove parlReplay_move(const ParlReplay* const r, const uint32_t n)
+{
+    return parlRecord_unpackMove(r->moves[n]);
+}
+
+bool parlReplay_seek(const ParlReplay* const r, const uint32_t n, ParlGame* const out)
+{
+    if(n > r->numMoves)
+        return false;
+
+    ParlGame g = r->checkpoints[n / r->interval];
+
+    // These were all checked in parlReplay_init
+    for(register uint32_t i = n - n % r->interval; i < n; ++i)
+    {
+        const ParlMove m = parlReplay_move(r, i);
+        parlGame_applyAction(&g, m.action, m.idxA, m.idxB, m.idxC);
+    }
+
+    *out = g;
+    return true;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file
+ * @brief Reconstructs the states of a recorded game, at any move, from its start state and moves.
+ *
+ * @details
+ * `parlReplay_init` streams every move through `parlGame_applyAction` once, checking each against
+ * `parlGame_legalActions` on the way, and keeps a copy of the state every `interval` moves. `parlReplay_seek` then
+ * starts from the nearest copy at or before the requested move, so it applies fewer than `interval` moves instead of
+ * replaying the whole game. A smaller interval makes seeking faster at the cost of one `ParlGame` of memory per copy.
+ */
+
+#ifndef PARLIAMENT_REPLAY_H
+#define PARLIAMENT_REPLAY_H
+
+#include "record.h"
+
+/**
+ * @brief A recorded game with a copy of its state every so many moves.
+ */
+typedef struct ParlReplay
+{
+    /**
+     * The recorded moves. These point into the log the game was read from, which must stay open for as long as the
+     * replay is used.
+     */
+    const ParlPackedMove* moves;
+
+    /**
+     * The number of moves that were recorded.
+     */
+    uint32_t numRecordedMoves;
+
+    /**
+     * The number of moves, counting from the start, that were legal. If this is less than `numRecordedMoves`, move
+     * number `numMoves` was illegal, and the replay stops before it.
+     */
+    uint32_t numMoves;
+
+    /**
+     * The number of moves between each copy of the state.
+     */
+    uint32_t interval;
+
+    /**
+     * `checkpoints[i]` is the state after `i * interval` moves, for every such state up to `numMoves`.
+     */
+    ParlGame* checkpoints;
+} ParlReplay;
+
+/**
+ * @brief Replays `e` once, checking that every move is legal and keeping a copy of the state every `interval` moves.
+ * @note When every hand is known, `SELF_DRAW` is accepted wherever `DRAW` is legal, since that is how
+ * `parlPerfect_applyAction` draws.
+ * @param r
+ * @param e The game to replay. Its log must stay open for as long as `r` is used.
+ * @param interval The number of moves between each copy of the state. Must be positive.
+ * @return Whether the start state could be unpacked and memory could be allocated. An illegal move doesn't cause this
+ * to fail; check `r->numMoves` against `r->numRecordedMoves` for that.
+ */
+bool parlReplay_init(ParlReplay* r, const ParlRecordEntry* e, uint32_t interval);
+
+/**
+ * @brief Frees the memory allocated for `r`, not including the `ParlReplay` struct itself.
+ * @param r
+ */
+void parlReplay_free(ParlReplay* r);
+
+/**
+ * @param r
+ * @param n
+ * @return The `n`th move, counting from 0.
+ */
+ParlMove parlReplay_move(const ParlReplay* r, uint32_t n);
+
+/**
+ * @brief Reconstructs the state after the first `n` moves, by applying fewer than `r->interval` moves to a copy.
+ * @param r
+ * @param n The number of moves, where 0 is the start state.
+ * @param out
+ * @return Whether `n` is at most `r->numMoves`. If not, `out` is left alone.
+ */
+bool parlReplay_seek(const ParlReplay* r, uint32_t n, ParlGame* out);
+
+#endif //PARLIAMENT_REPLAY_H
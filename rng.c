@@ -0,0 +1,14 @@
+#include "rng.h"
+
+void parlRng_seed(ParlRng* const r, uint64_t seed)
+{
+    // SplitMix64 spreads the seed out so that no state word is all zero
+    for(register int i = 0; i < 4; ++i)
+    {
+        register uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        r->s[i] = z ^ (z >> 31);
+    }
+}
@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @brief A small, fast random number generator for sampling and playouts.
+ *
+ * @details
+ * This is xoshiro256** seeded through SplitMix64. Its whole state is four words that live wherever the caller puts
+ * them, so it never allocates, and each search thread can own a generator without any locking. The hot functions are
+ * defined here so they can be inlined into sampling loops.
+ */
+
+#ifndef PARLIAMENT_RNG_H
+#define PARLIAMENT_RNG_H
+
+#include <stdint.h>
+
+typedef struct ParlRng
+{
+    uint64_t s[4];
+} ParlRng;
+
+/**
+ * @brief Seeds `r`. Different seeds give unrelated sequences, even if they only differ by one bit.
+ * @param r
+ * @param seed
+ */
+void parlRng_seed(ParlRng* r, uint64_t seed);
+
+/**
+ * @param r
+ * @return The next 64 random bits from `r`.
+ */
+static inline uint64_t parlRng_next(ParlRng* const r)
+{
+#define PARL_RNG_ROTL(x, k) ((x) << (k) | (x) >> (64 - (k)))
+    const uint64_t result = PARL_RNG_ROTL(r->s[1] * 5, 7) * 9,
+        t = r->s[1] << 17;
+
+    r->s[2] ^= r->s[0];
+    r->s[3] ^= r->s[1];
+    r->s[1] ^= r->s[2];
+    r->s[0] ^= r->s[3];
+    r->s[2] ^= t;
+    r->s[3] = PARL_RNG_ROTL(r->s[3], 45);
+
+    return result;
+}
+
+/**
+ * @param r
+ * @param n Must not be 0.
+ * @return A uniformly random integer in [0, n).
+ * @note This uses Lemire's multiply-and-shift method, which only needs a division in the rare case that the first draw
+ * lands in the biased region.
+ */
+static inline uint32_t parlRng_below(ParlRng* const r, const uint32_t n)
+{
+    register uint64_t m = (uint64_t)(uint32_t)parlRng_next(r) * n;
+
+    if((uint32_t)m < n)
+    {
+        const uint32_t threshold = -n % n;
+
+        while((uint32_t)m < threshold)
+            m = (uint64_t)(uint32_t)parlRng_next(r) * n;
+    }
+
+    return m >> 32;
+}
+
+#endif //PARLIAMENT_RNG_H
@@ -0,0 +1,552 @@
+#include "search.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * The number of slots in `ParlSearchWorker.moveSet`. This must be a power of 2 and comfortably more than
+ * `PARL_MAX_MOVES`.
+ */
+#define PARL_SEARCH_MOVE_SET_SIZE (2 * PARL_MAX_MOVES)
+
+/**
+ * The deepest the tree is descended in one iteration.
+ */
+#define PARL_SEARCH_MAX_DEPTH 1024
+
+/**
+ * How many iterations each thread runs between checks of the clock.
+ */
+#define PARL_SEARCH_CLOCK_INTERVAL 16
+
+/**
+ * Set in every occupied slot of a move set, so that an empty slot is 0.
+ */
+#define PARL_SEARCH_OCCUPIED (1u << 30)
+
+/**
+ * Set in a slot of a move set once the move is found to already have a child.
+ */
+#define PARL_SEARCH_HAS_CHILD (1u << 31)
+
+#define PARL_SEARCH_LOAD(x) atomic_load_explicit(&(x), memory_order_relaxed)
+#define PARL_SEARCH_ADD(x, n) atomic_fetch_add_explicit(&(x), (n), memory_order_relaxed)
+
+static inline uint32_t parlSearch_packMove(const ParlMove m)
+{
+    return m.action | m.idxA << 8 | m.idxB << 14 | m.idxC << 20 | PARL_SEARCH_OCCUPIED;
+}
+
+static inline ParlMove parlSearch_unpackMove(const uint32_t packed)
+{
+    return (ParlMove){
+        .action = packed & 0xFF,
+        .idxA = packed >> 8 & 0x3F,
+        .idxB = packed >> 14 & 0x3F,
+        .idxC = packed >> 20 & 0x3F
+    };
+}
+
+/**
+ * @return The slot in `moveSet` that holds `m`, or the empty slot where it would go if it isn't there.
+ */
+static inline uint32_t* parlSearch_findMove(uint32_t* const moveSet, const ParlMove m)
+{
+    const register uint32_t packed = parlSearch_packMove(m);
+    register uint32_t slot = packed * 0x9E3779B1u >> 16 & (PARL_SEARCH_MOVE_SET_SIZE - 1);
+
+    while(moveSet[slot] && (moveSet[slot] & ~PARL_SEARCH_HAS_CHILD) != packed)
+        slot = (slot + 1) & (PARL_SEARCH_MOVE_SET_SIZE - 1);
+
+    return &moveSet[slot];
+}
+
+int parlSearch_randomPolicy(const ParlPerfectGame* const pg,
+                            const ParlMove* const moves,
+                            const int numMoves,
+                            ParlRng* const r,
+                            void* const ctx)
+{
+    (void)pg;
+    (void)moves;
+    (void)ctx;
+    return parlRng_below(r, numMoves);
+}
+
+/**
+ * @brief Picks the child of `node` to descend into in the determinization `pg`, creating it if there are legal moves
+ * that don't have children yet, and applies its move to `pg`. The child's visit is counted right away.
+ * @param expanded Set to whether the child was just created.
+ * @return The child, or 0 if there's nothing to descend into.
+ */
+static uint32_t parlSearch_select(ParlSearchWorker* const w,
+                                  const uint32_t node,
+                                  ParlPerfectGame* const pg,
+                                  const float exploration,
+                                  bool* const expanded)
+{
+    ParlNode* const nodes = w->search->nodes;
+    register int numMoves = parlGame_generateMoves(&pg->g, w->moves, PARL_MAX_MOVES);
+    register uint32_t best = 0;
+    register float bestScore = -INFINITY;
+    register int numUntried;
+
+    if(numMoves > PARL_MAX_MOVES)
+        numMoves = PARL_MAX_MOVES;
+    numUntried = numMoves;
+    *expanded = false;
+
+    for(register int i = 0; i < numMoves; ++i)
+        *parlSearch_findMove(w->moveSet, w->moves[i]) = parlSearch_packMove(w->moves[i]);
+
+    /* Step 1: Score the children whose moves are legal in this determinization */
+
+    for(
+        register uint32_t c = atomic_load_explicit(&nodes[node].firstChild, memory_order_acquire);
+        c;
+        c = nodes[c].nextSibling
+    )
+    {
+        ParlNode* const child = &nodes[c];
+        uint32_t* const slot = parlSearch_findMove(w->moveSet, child->move);
+
+        if(!*slot)
+            continue;
+
+        *slot |= PARL_SEARCH_HAS_CHILD;
+        --numUntried;
+
+        // Children are created with one visit, so this never divides by 0
+        const register float visits = PARL_SEARCH_LOAD(child->visits),
+            availability = PARL_SEARCH_ADD(child->availability, 1) + 1,
+            score = PARL_SEARCH_LOAD(child->wins) / visits + exploration * sqrtf(logf(availability) / visits);
+
+        if(score > bestScore)
+        {
+            best = c;
+            bestScore = score;
+        }
+    }
+
+    /* Step 2: Expand a random untried move instead if there is one */
+
+    if(numUntried && w->nextNode < w->endNode)
+    {
+        register int k = parlRng_below(&w->rng, numUntried);
+        register int i = 0;
+
+        while(*parlSearch_findMove(w->moveSet, w->moves[i]) & PARL_SEARCH_HAS_CHILD || k--)
+            ++i;
+
+        const register uint32_t created = w->nextNode;
+        uint32_t head = atomic_load_explicit(&nodes[node].firstChild, memory_order_acquire);
+
+        nodes[created] = (ParlNode){
+            .move = w->moves[i],
+            .mover = pg->g.turn,
+            .firstChild = 0,
+            .visits = 1,
+            .availability = 1,
+            .wins = 0
+        };
+
+        for(;;)
+        {
+            nodes[created].nextSibling = head;
+
+            if(atomic_compare_exchange_weak_explicit(
+                &nodes[node].firstChild, &head, created, memory_order_release, memory_order_acquire
+            ))
+            {
+                ++w->nextNode;
+                best = created;
+                *expanded = true;
+                break;
+            }
+
+            // Another thread added children in the meantime -- if it added this move, use its child instead
+            register uint32_t c = head;
+            while(c && parlSearch_packMove(nodes[c].move) != parlSearch_packMove(w->moves[i]))
+                c = nodes[c].nextSibling;
+
+            if(c)
+            {
+                best = c;
+                break;
+            }
+        }
+    }
+
+    if(best && !*expanded)
+        PARL_SEARCH_ADD(nodes[best].visits, 1);
+
+    // Leave the move set empty for next time. Clearing a slot would cut off the probe of any move that was inserted
+    // after it and collided, so the moves are cleared in the reverse of the order they were inserted in.
+    for(register int i = numMoves - 1; i >= 0; --i)
+        *parlSearch_findMove(w->moveSet, w->moves[i]) = 0;
+
+    if(best && !parlPerfect_applyMove(pg, nodes[best].move))
+        return 0;
+
+    return best;
+}
+
+/**
+ * @brief Runs one iteration of the search on `w`'s tree.
+ * @return Whether the root could be determinized.
+ */
+static bool parlSearch_iterate(ParlSearchWorker* const w)
+{
+    const ParlSearch* const s = w->search;
+    const ParlSearchConfig* const cfg = s->cfg;
+    ParlNode* const nodes = s->nodes;
+    ParlWorld world;
+    ParlPerfectGame pg;
+    uint32_t path[PARL_SEARCH_MAX_DEPTH];
+    register int depth = 0;
+    bool expanded = false;
+
+    if(!(cfg->belief
+        ? parlWorld_sampleBelief(&world, s->g, cfg->belief, &w->rng)
+        : parlWorld_sample(&world, s->g, &w->rng)))
+        return false;
+
+    parlPerfect_fromWorld(&pg, s->g, &world, parlRng_next(&w->rng));
+
+    /* Step 1: Descend the tree, growing it by one node */
+
+    path[depth++] = w->root;
+    PARL_SEARCH_ADD(nodes[w->root].visits, 1);
+
+    while(!expanded && pg.g.mode != GAME_OVER && depth < PARL_SEARCH_MAX_DEPTH)
+    {
+        const register uint32_t child = parlSearch_select(w, path[depth - 1], &pg, cfg->exploration, &expanded);
+
+        if(!child)
+            break;
+
+        path[depth++] = child;
+    }
+
+    /* Step 2: Play out the rest of the game */
+
+    const ParlRolloutPolicy policy = cfg->policy ? cfg->policy : parlSearch_randomPolicy;
+
+    for(register int plies = 0; plies < cfg->maxRolloutPlies && pg.g.mode != GAME_OVER; ++plies)
+    {
+        const register int numMoves = parlGame_generateMoves(&pg.g, w->moves, PARL_MAX_MOVES);
+
+        if(!numMoves)
+            break;
+
+        const register int i = policy(&pg, w->moves, numMoves < PARL_MAX_MOVES ? numMoves : PARL_MAX_MOVES, &w->rng,
+                                      cfg->policyCtx);
+
+        if(!parlPerfect_applyMove(&pg, w->moves[i]))
+            break;
+    }
+
+    /* Step 3: Credit the winner -- the visits were already counted on the way down */
+
+    const register ParlPlayer winner = PARL_WINNER(&pg.g);
+
+    for(register int i = 1; i < depth; ++i)
+        if(nodes[path[i]].mover == winner)
+            PARL_SEARCH_ADD(nodes[path[i]].wins, 1);
+
+    return true;
+}
+
+/**
+ * @brief Runs iterations on `w` until the search's budget is used up.
+ */
+static void parlSearch_work(ParlSearchWorker* const w)
+{
+    ParlSearch* const s = w->search;
+    const ParlSearchConfig* const cfg = s->cfg;
+
+    for(register long i = 0;; ++i)
+    {
+        if(cfg->maxMs && i % PARL_SEARCH_CLOCK_INTERVAL == 0 && parlTimer_nowNs() >= s->deadlineNs)
+            break;
+
+        if(cfg->stop && atomic_load_explicit(cfg->stop, memory_order_relaxed))
+            break;
+
+        // Claim an iteration so that the threads don't run more than `maxIterations` between them
+        if(PARL_SEARCH_ADD(s->iterations, 1) >= cfg->maxIterations && cfg->maxIterations)
+            break;
+
+        if(!parlSearch_iterate(w))
+            break;
+    }
+}
+
+static void* parlSearch_threadMain(void* const arg)
+{
+    ParlSearchWorker* const w = arg;
+    ParlSearch* const s = w->search;
+    register unsigned long lastGeneration = 0;
+
+    pthread_mutex_lock(&s->lock);
+
+    for(;;)
+    {
+        while(s->generation == lastGeneration && !s->quit)
+            pthread_cond_wait(&s->startCond, &s->lock);
+
+        if(s->quit)
+            break;
+
+        lastGeneration = s->generation;
+        pthread_mutex_unlock(&s->lock);
+
+        parlSearch_work(w);
+
+        pthread_mutex_lock(&s->lock);
+        if(--s->numRunning == 0)
+            pthread_cond_signal(&s->doneCond);
+    }
+
+    pthread_mutex_unlock(&s->lock);
+    return NULL;
+}
+
+bool parlSearch_init(ParlSearch* const s, const uint32_t capacity, const int numThreads)
+{
+    register int numStarted = 1;
+
+    *s = (ParlSearch){
+        .nodes = malloc(capacity * sizeof(ParlNode)),
+        .capacity = capacity,
+        .workers = calloc(numThreads, sizeof(ParlSearchWorker)),
+        .numThreads = numThreads,
+        .rootVisits = calloc(PARL_SEARCH_MOVE_SET_SIZE, sizeof(uint32_t)),
+        .iterations = 0,
+        .hasTree = false,
+        .generation = 0,
+        .numRunning = 0,
+        .quit = false
+    };
+
+    // Every thread needs room for at least a root and one child
+    if(!s->nodes || !s->workers || !s->rootVisits || numThreads < 1 || capacity / numThreads < 2)
+        goto fail;
+
+    for(register int t = 0; t < numThreads; ++t)
+    {
+        s->workers[t].search = s;
+        s->workers[t].moves = malloc(PARL_MAX_MOVES * sizeof(ParlMove));
+        s->workers[t].moveSet = calloc(PARL_SEARCH_MOVE_SET_SIZE, sizeof(uint32_t));
+
+        if(!s->workers[t].moves || !s->workers[t].moveSet)
+            goto fail;
+    }
+
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->startCond, NULL);
+    pthread_cond_init(&s->doneCond, NULL);
+
+    // The thread that calls `parlSearch_run` is the first worker, so it doesn't need a thread of its own
+    for(; numStarted < numThreads; ++numStarted)
+        if(pthread_create(&s->workers[numStarted].thread, NULL, parlSearch_threadMain, &s->workers[numStarted]))
+        {
+            s->numThreads = numStarted;
+            parlSearch_free(s);
+            return false;
+        }
+
+    return true;
+
+    fail:
+
+    if(s->workers)
+        for(register int t = 0; t < numThreads; ++t)
+        {
+            free(s->workers[t].moves);
+            free(s->workers[t].moveSet);
+        }
+
+    free(s->workers);
+    free(s->rootVisits);
+    free(s->nodes);
+    s->workers = NULL;
+    s->rootVisits = NULL;
+    s->nodes = NULL;
+    return false;
+}
+
+void parlSearch_free(ParlSearch* const s)
+{
+    pthread_mutex_lock(&s->lock);
+    s->quit = true;
+    pthread_cond_broadcast(&s->startCond);
+    pthread_mutex_unlock(&s->lock);
+
+    for(register int t = 1; t < s->numThreads; ++t)
+        pthread_join(s->workers[t].thread, NULL);
+
+    pthread_mutex_destroy(&s->lock);
+    pthread_cond_destroy(&s->startCond);
+    pthread_cond_destroy(&s->doneCond);
+
+    for(register int t = 0; t < s->numThreads; ++t)
+    {
+        free(s->workers[t].moves);
+        free(s->workers[t].moveSet);
+    }
+
+    free(s->workers);
+    free(s->rootVisits);
+    free(s->nodes);
+    s->workers = NULL;
+    s->rootVisits = NULL;
+    s->nodes = NULL;
+}
+
+bool parlSearch_run(ParlSearch* const s, const ParlGame* const g, const ParlSearchConfig* const cfg, ParlMove* const best)
+{
+    ParlSearchWorker* const first = &s->workers[0];
+    const register uint32_t arenaSize = s->capacity / s->numThreads;
+    const register bool rootParallel = cfg->parallelism == PARL_SEARCH_ROOT_PARALLEL;
+
+    if(!parlGame_generateMoves(g, first->moves, PARL_MAX_MOVES))
+        return false;
+
+    // If nothing else works out, at least recommend a legal move
+    *best = first->moves[0];
+
+    s->g = g;
+    s->cfg = cfg;
+    s->deadlineNs = parlTimer_nowNs() + (uint64_t)(cfg->maxMs * 1e6);
+    atomic_store(&s->iterations, 0);
+
+    /* Step 1: Give every thread its part of the node pool and, if it grows its own tree, a root */
+
+    // Root-parallel trees and a shared tree lay out the node pool differently, so one can't be reused as the other
+    register bool reuse = cfg->reuseTree && s->hasTree && s->treeHash == g->hash
+        && s->treeParallelism == cfg->parallelism;
+
+    // The nodes that were cut off by `parlSearch_advance` aren't freed, so the pool only fills up
+    for(register int t = 0; t < s->numThreads && reuse; ++t)
+        if(s->workers[t].endNode - s->workers[t].nextNode < arenaSize / 2)
+            reuse = false;
+
+    for(register int t = 0; t < s->numThreads; ++t)
+    {
+        ParlSearchWorker* const w = &s->workers[t];
+
+        parlRng_seed(&w->rng, cfg->seed + t);
+
+        if(reuse)
+            continue;
+
+        w->root = rootParallel ? t * arenaSize : 0;
+        w->nextNode = t * arenaSize;
+        w->endNode = w->nextNode + arenaSize;
+
+        if(w->root == w->nextNode)
+            s->nodes[w->nextNode++] = (ParlNode){
+                .mover = g->turn,
+                .firstChild = 0,
+                .nextSibling = 0,
+                .visits = 0,
+                .availability = 0,
+                .wins = 0
+            };
+    }
+
+    /* Step 2: Search on every thread until the budget runs out */
+
+    pthread_mutex_lock(&s->lock);
+    s->numRunning = s->numThreads - 1;
+    ++s->generation;
+    pthread_cond_broadcast(&s->startCond);
+    pthread_mutex_unlock(&s->lock);
+
+    parlSearch_work(first);
+
+    pthread_mutex_lock(&s->lock);
+    while(s->numRunning)
+        pthread_cond_wait(&s->doneCond, &s->lock);
+    pthread_mutex_unlock(&s->lock);
+
+    if(cfg->maxIterations && s->iterations > cfg->maxIterations)
+        s->iterations = cfg->maxIterations;
+
+    /* Step 3: Add up the root moves' visits over every tree and recommend the most visited move */
+
+    uint32_t* const moveSet = first->moveSet;
+    register uint32_t mostVisits = 0;
+
+    for(register int t = 0; t < (rootParallel ? s->numThreads : 1); ++t)
+        for(register uint32_t c = s->nodes[s->workers[t].root].firstChild; c; c = s->nodes[c].nextSibling)
+        {
+            uint32_t* const slot = parlSearch_findMove(moveSet, s->nodes[c].move);
+            register uint32_t* const total = &s->rootVisits[slot - moveSet];
+
+            *slot = parlSearch_packMove(s->nodes[c].move);
+            *total += s->nodes[c].visits;
+
+            if(*total > mostVisits)
+            {
+                mostVisits = *total;
+                *best = parlSearch_unpackMove(*slot);
+            }
+        }
+
+    memset(moveSet, 0, PARL_SEARCH_MOVE_SET_SIZE * sizeof(uint32_t));
+    memset(s->rootVisits, 0, PARL_SEARCH_MOVE_SET_SIZE * sizeof(uint32_t));
+
+    s->hasTree = true;
+    s->treeHash = g->hash;
+    s->treeParallelism = cfg->parallelism;
+    return true;
+}
+
+/**
+ * @return Whether `a` and `b` are the same card or both jokers. In distinct joker mode, which joker a move in the tree
+ * uses depends on the determinization it was made in.
+ */
+static inline bool parlSearch_sameCard(const ParlIdx a, const ParlIdx b)
+{
+    return a == b || (PARL_IS_JOKER(a) && PARL_IS_JOKER(b) && !PARL_IS_NO_ARG(a) && !PARL_IS_NO_ARG(b));
+}
+
+bool parlSearch_advance(ParlSearch* const s, const ParlMove m, const ParlGame* const after)
+{
+    if(!s->hasTree)
+        return false;
+
+    // With PARL_SEARCH_TREE_PARALLEL, every worker has the same root and finds the same child
+    for(register int t = 0; t < s->numThreads; ++t)
+    {
+        ParlSearchWorker* const w = &s->workers[t];
+        register uint32_t c = s->nodes[w->root].firstChild;
+
+        for(; c; c = s->nodes[c].nextSibling)
+        {
+            const ParlMove child = s->nodes[c].move;
+
+            if(m.action == DRAW || m.action == SELF_DRAW
+                ? child.action == DRAW
+                : child.action == m.action
+                    && parlSearch_sameCard(child.idxA, m.idxA)
+                    && parlSearch_sameCard(child.idxB, m.idxB)
+                    && parlSearch_sameCard(child.idxC, m.idxC))
+                break;
+        }
+
+        if(!c)
+        {
+            s->hasTree = false;
+            return false;
+        }
+
+        w->root = c;
+    }
+
+    s->treeHash = after->hash;
+    return true;
+}
@@ -0,0 +1,295 @@
+/**
+ * @file
+ * @brief An information-set Monte Carlo tree search (ISMCTS) engine that recommends a move for a `ParlGame`.
+ *
+ * @details
+ * This is single-observer ISMCTS. Every iteration runs on a fresh determinization: the face-down cards are dealt at
+ * random with `parlWorld_sample`, or by a `ParlBelief` with `parlWorld_sampleBelief`, and the resulting
+ * full-information game is played out with perfect.h. In each node, only the children whose moves are legal in the
+ * current determinization are considered. They're chosen by UCT using how many times they were available in place of
+ * the parent's visit count. A rollout policy decides the moves after
+ * the tree runs out. Each node is credited with a win when the player who made its move wins the game.
+ *
+ * A search can run on several threads, which are started once in `parlSearch_init` and reused for every search.
+ * - With `PARL_SEARCH_ROOT_PARALLEL`, each thread grows its own tree, and the root moves' visit counts are added up at
+ *   the end.
+ * - With `PARL_SEARCH_TREE_PARALLEL`, all threads grow one shared tree. A thread counts a visit to a node as soon as it
+ *   passes through it and only adds the win once the playout is over. Until then, the visit acts as a virtual loss
+ *   that steers the other threads elsewhere.
+ *
+ * Nodes come from a pool that's allocated once in `parlSearch_init` and split evenly between the threads. Each thread
+ * only takes nodes from its own part. Searching never allocates, and once a thread's part is full, it stops growing
+ * the tree.
+ *
+ * With `reuseTree`, a search continues growing the tree left by the last one instead of starting over, as long as it's
+ * for the same position. `parlSearch_advance` follows a move down that tree so that it's kept across turns too.
+ *
+ * Drawing is a single `DRAW` move in the tree, since which card comes up is decided by the determinization. When the
+ * known player is recommended `DRAW`, they should draw and then report the card with `SELF_DRAW` as usual.
+ */
+
+#ifndef PARLIAMENT_SEARCH_H
+#define PARLIAMENT_SEARCH_H
+
+#include "game.h"
+#include "perfect.h"
+#include "rng.h"
+#include "timer.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+/**
+ * @brief Picks the next move of a rollout.
+ * @param pg The game being played out.
+ * @param moves Every legal move in `pg`.
+ * @param numMoves The number of moves in `moves`, which is at least 1.
+ * @param r
+ * @param ctx Whatever was passed as `ParlSearchConfig.policyCtx`.
+ * @return The index in `moves` of the move to play.
+ */
+typedef int (*ParlRolloutPolicy)(const ParlPerfectGame* pg, const ParlMove* moves, int numMoves, ParlRng* r, void* ctx);
+
+/**
+ * @brief The default rollout policy, which picks uniformly at random.
+ */
+int parlSearch_randomPolicy(const ParlPerfectGame* pg, const ParlMove* moves, int numMoves, ParlRng* r, void* ctx);
+
+/**
+ * How the threads of a search share work.
+ */
+typedef enum ParlSearchParallelism
+{
+    PARL_SEARCH_ROOT_PARALLEL,
+    PARL_SEARCH_TREE_PARALLEL
+} ParlSearchParallelism;
+
+typedef struct ParlSearchConfig
+{
+    /**
+     * The most iterations to run across all threads, or 0 for no limit.
+     */
+    long maxIterations;
+
+    /**
+     * The most time to take in milliseconds, or 0 for no limit. At least one of this and `maxIterations` must be set.
+     */
+    double maxMs;
+
+    /**
+     * The UCT exploration constant.
+     */
+    float exploration;
+
+    /**
+     * Rollouts that haven't ended after this many moves are scored as a loss for everyone.
+     */
+    int maxRolloutPlies;
+
+    /**
+     * The rollout policy, or `NULL` for `parlSearch_randomPolicy`. It's called from every thread at once.
+     */
+    ParlRolloutPolicy policy;
+
+    void* policyCtx;
+
+    ParlSearchParallelism parallelism;
+
+    uint64_t seed;
+
+    /**
+     * Whether to keep growing the tree from the last search, or from `parlSearch_advance`, if it was for the same
+     * position. The tree is started over anyway once less than half of any thread's part of the node pool is free.
+     */
+    bool reuseTree;
+
+    /**
+     * If not `NULL`, the search ends as soon as this becomes true, which another thread can do at any time.
+     */
+    const atomic_bool* stop;
+
+    /**
+     * If not `NULL`, determinizations are dealt with `parlWorld_sampleBelief` instead of `parlWorld_sample`. It must
+     * describe the position being searched and stay unchanged during the search.
+     */
+    const ParlBelief* belief;
+} ParlSearchConfig;
+
+/**
+ * A `ParlSearchConfig` with reasonable settings for a one-second search.
+ */
+#define PARL_SEARCH_DEFAULT_CONFIG ((ParlSearchConfig){ \
+    .maxIterations = 0,                                 \
+    .maxMs = 1000,                                      \
+    .exploration = 0.7f,                                \
+    .maxRolloutPlies = 2000,                            \
+    .policy = NULL,                                     \
+    .policyCtx = NULL,                                  \
+    .parallelism = PARL_SEARCH_TREE_PARALLEL,           \
+    .seed = 0,                                          \
+    .reuseTree = false,                                 \
+    .stop = NULL,                                       \
+    .belief = NULL                                      \
+})
+
+/**
+ * @brief A node in the search tree.
+ */
+typedef struct ParlNode
+{
+    /**
+     * The move that leads to this node from its parent.
+     */
+    ParlMove move;
+
+    /**
+     * The player who made `move`.
+     */
+    ParlPlayer mover;
+
+    /**
+     * The newest child. Children are linked through `nextSibling`. Both are indices into the node pool, or 0 for none.
+     * Node 0 is always a root, so it's never anyone's child or sibling.
+     */
+    _Atomic uint32_t firstChild;
+
+    uint32_t nextSibling;
+
+    _Atomic uint32_t visits;
+
+    /**
+     * The number of times this node's move was legal when its parent was visited.
+     */
+    _Atomic uint32_t availability;
+
+    /**
+     * The number of visits that ended in a win for `mover`.
+     */
+    _Atomic uint32_t wins;
+} ParlNode;
+
+/**
+ * @brief Everything one thread of a search uses without sharing it.
+ */
+typedef struct ParlSearchWorker
+{
+    struct ParlSearch* search;
+
+    /**
+     * The root of the tree this thread grows.
+     */
+    uint32_t root;
+
+    /**
+     * This thread's part of the node pool is [`nextNode`, `endNode`). `nextNode` is the next one it will take.
+     */
+    uint32_t nextNode, endNode;
+
+    /**
+     * Scratch space for the moves legal in one position.
+     */
+    ParlMove* moves;
+
+    /**
+     * Scratch space for looking up which of `moves` already have children.
+     */
+    uint32_t* moveSet;
+
+    ParlRng rng;
+
+    pthread_t thread;
+} ParlSearchWorker;
+
+typedef struct ParlSearch
+{
+    ParlNode* nodes;
+    uint32_t capacity;
+
+    ParlSearchWorker* workers;
+    int numThreads;
+
+    /**
+     * Scratch space for adding up the root moves' visit counts, one per slot of the first worker's `moveSet`.
+     */
+    uint32_t* rootVisits;
+
+    /**
+     * The number of iterations run so far by the current or last search, across all threads.
+     */
+    _Atomic long iterations;
+
+    /* The search currently being run */
+
+    const ParlGame* g;
+    const ParlSearchConfig* cfg;
+    uint64_t deadlineNs;
+
+    /* The tree left for the next search */
+
+    /**
+     * Whether the workers' roots and parts of the node pool still hold a tree, for the position with hash `treeHash`.
+     */
+    bool hasTree;
+
+    uint64_t treeHash;
+
+    /**
+     * The `parallelism` that the tree was grown with.
+     */
+    ParlSearchParallelism treeParallelism;
+
+    /* Thread pool */
+
+    pthread_mutex_t lock;
+    pthread_cond_t startCond, doneCond;
+
+    /**
+     * Incremented to start a search on every thread.
+     */
+    unsigned long generation;
+
+    /**
+     * The number of threads other than the caller's that are still searching.
+     */
+    int numRunning;
+
+    bool quit;
+} ParlSearch;
+
+/**
+ * @brief Allocates everything a search needs and starts its threads.
+ * @param s
+ * @param capacity The most nodes the trees may hold between all threads.
+ * @param numThreads The number of threads to search with, including the one calling `parlSearch_run`.
+ * @return Whether the initialization was successful.
+ */
+bool parlSearch_init(ParlSearch* s, uint32_t capacity, int numThreads);
+
+/**
+ * @brief Stops the threads of `s` and frees the memory allocated for it, not including the `ParlSearch` struct itself.
+ * @param s
+ */
+void parlSearch_free(ParlSearch* s);
+
+/**
+ * @brief Searches `g` and recommends a move for the player whose turn it is.
+ * @param s
+ * @param g
+ * @param cfg
+ * @param best Where to write the recommended move, which is the most visited move at the root.
+ * @return Whether there was a move to recommend, which is false only if `g` has no legal moves.
+ */
+bool parlSearch_run(ParlSearch* s, const ParlGame* g, const ParlSearchConfig* cfg, ParlMove* best);
+
+/**
+ * @brief Moves the root of the tree left by the last search down to the child for `m`, so that a search of `after` with
+ * `reuseTree` starts from what is already known about it.
+ * @note `SELF_DRAW` follows the `DRAW` child, since which card was drawn is left to the determinizations.
+ * @param s
+ * @param m A move just made from the root position.
+ * @param after The position after `m`.
+ * @return Whether the tree had a child for `m`. If not, the tree is dropped, and the next search starts over.
+ */
+bool parlSearch_advance(ParlSearch* s, ParlMove m, const ParlGame* after);
+
+#endif //PARLIAMENT_SEARCH_H
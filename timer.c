@@ -2,28 +2,152 @@
 // Created by Weiju Wang on 8/21/24.
 //
 
+// For clock_gettime when compiling without GNU extensions
+#define _POSIX_C_SOURCE 199309L
+
 #include "timer.h"
 
+#include <stdlib.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+uint64_t parlTimer_nowNs(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (uint64_t)count.QuadPart / frequency.QuadPart * 1000000000
+        + (uint64_t)count.QuadPart % frequency.QuadPart * 1000000000 / frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
 void parlTimer_start(ParlTimer* t)
 {
-    t->start = clock();
+    t->startCycles = parlTimer_cycleCount();
+    t->startNs = parlTimer_nowNs();
 }
+
 void parlTimer_stop(ParlTimer* t)
 {
-    t->end = clock();
+    t->endNs = parlTimer_nowNs();
+    t->endCycles = parlTimer_cycleCount();
+}
+
+uint64_t parlTimer_lap(ParlTimer* t, ParlTimerStats* s)
+{
+    parlTimer_stop(t);
+    parlTimerStats_add(s, parlTimer_ns(t));
+
+    t->startNs = t->endNs;
+    t->startCycles = t->endCycles;
+    return parlTimer_ns(t);
+}
+
+uint64_t parlTimer_ns(const ParlTimer* t)
+{
+    return t->endNs - t->startNs;
+}
+
+uint64_t parlTimer_cycles(const ParlTimer* t)
+{
+    return t->endCycles - t->startCycles;
 }
 
 double parlTimer_secs(const ParlTimer* t)
 {
-    return (double)(t->end - t->start) / CLOCKS_PER_SEC;
+    return parlTimer_ns(t) / 1e9;
 }
 
 double parlTimer_ms(const ParlTimer* t)
 {
-    return 1000 * parlTimer_secs(t);
+    return parlTimer_ns(t) / 1e6;
+}
+
+int64_t parlTimer_microSecs(const ParlTimer* t)
+{
+    return parlTimer_ns(t) / 1000;
+}
+
+bool parlTimerStats_init(ParlTimerStats* s, int capacity)
+{
+    s->samples = malloc(capacity * sizeof(double));
+    s->capacity = capacity;
+    parlTimerStats_clear(s);
+    return s->samples;
 }
 
-int parlTimer_microSecs(const ParlTimer* t)
+void parlTimerStats_free(ParlTimerStats* s)
 {
-    return 1000000 * parlTimer_secs(t);
-}
\ No newline at end of file
+    free(s->samples);
+    s->samples = NULL;
+}
+
+void parlTimerStats_clear(ParlTimerStats* s)
+{
+    s->numSamples = 0;
+    s->totalNs = 0;
+    s->count = 0;
+    parlRng_seed(&s->rng, 1);
+}
+
+void parlTimerStats_add(ParlTimerStats* s, double ns)
+{
+    if(s->numSamples < s->capacity)
+        s->samples[s->numSamples++] = ns;
+    else
+    {
+        // Reservoir sampling: keep the new sample with chance capacity / (count + 1), in place of a random kept one
+        const uint64_t slot = parlRng_next(&s->rng) % (uint64_t)(s->count + 1);
+
+        if(slot < (uint64_t)s->capacity)
+            s->samples[slot] = ns;
+    }
+
+    s->totalNs += ns;
+    ++s->count;
+}
+
+static int parlTimer_compareDoubles(const void* a, const void* b)
+{
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @return The sample nearest to percentile `p`, given as a fraction between 0 and 1, out of `n` sorted samples.
+ */
+static double parlTimer_percentile(const double* sorted, int n, double p)
+{
+    return sorted[(int)(p * (n - 1) + 0.5)];
+}
+
+void parlTimerStats_summarize(ParlTimerStats* s, ParlTimerSummary* out)
+{
+    const int n = s->numSamples;
+
+    *out = (ParlTimerSummary){.count = s->count};
+
+    if(!n)
+        return;
+
+    qsort(s->samples, n, sizeof(double), parlTimer_compareDoubles);
+
+    out->minNs = s->samples[0];
+    out->medianNs = parlTimer_percentile(s->samples, n, 0.5);
+    out->p90Ns = parlTimer_percentile(s->samples, n, 0.9);
+    out->p99Ns = parlTimer_percentile(s->samples, n, 0.99);
+    out->maxNs = s->samples[n - 1];
+    out->meanNs = s->totalNs / s->count;
+}
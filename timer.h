@@ -5,21 +5,145 @@
 #ifndef PARLIAMENT_TIMER_H
 #define PARLIAMENT_TIMER_H
 
-#include <time.h>
+#include <stdbool.h>
+#include <stdint.h>
 
+#include "rng.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PARL_TIMER_HAS_CYCLES 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define PARL_TIMER_HAS_CYCLES 1
+#else
+#define PARL_TIMER_HAS_CYCLES 0
+#endif
+
+/**
+ * Times an interval on the monotonic clock, and also in CPU cycles where `PARL_TIMER_HAS_CYCLES` is 1.
+ */
 typedef struct
 {
-    clock_t start, end;
+    uint64_t startNs, endNs;
+    uint64_t startCycles, endCycles;
 } ParlTimer;
 
+/**
+ * @brief Collects many timed samples, for example the laps of a `ParlTimer`, and summarizes them.
+ */
+typedef struct ParlTimerStats
+{
+    /**
+     * The samples in nanoseconds. Once there are more than `capacity` of them, this holds a uniformly random subset of
+     * `capacity` of them, so the percentiles describe every sample and not only the first few.
+     */
+    double* samples;
+
+    int numSamples, capacity;
+
+    /**
+     * The sum of every sample added, including any that didn't fit in `samples`.
+     */
+    double totalNs;
+
+    /**
+     * The number of samples added, including any that didn't fit in `samples`.
+     */
+    long count;
+
+    /**
+     * Picks which samples to keep once `samples` is full.
+     */
+    ParlRng rng;
+} ParlTimerStats;
+
+typedef struct ParlTimerSummary
+{
+    long count;
+    double minNs, medianNs, p90Ns, p99Ns, maxNs, meanNs;
+} ParlTimerSummary;
+
+/**
+ * @return The time on a monotonic clock in nanoseconds since some fixed point. Unlike `clock()`, this is wall-clock
+ * time, so it keeps counting while the process sleeps and doesn't add up the time of several threads.
+ */
+uint64_t parlTimer_nowNs(void);
+
+/**
+ * @return The CPU's cycle counter, or `parlTimer_nowNs()` if `PARL_TIMER_HAS_CYCLES` is 0.
+ * @note On most modern x86 CPUs this counts at a constant rate no matter the clock speed, so it measures time rather
+ * than work, and it's only comparable between readings on the same core.
+ */
+static inline uint64_t parlTimer_cycleCount(void)
+{
+#if PARL_TIMER_HAS_CYCLES
+    return __rdtsc();
+#else
+    return parlTimer_nowNs();
+#endif
+}
+
 void parlTimer_start(ParlTimer* t);
 
 void parlTimer_stop(ParlTimer* t);
 
+/**
+ * @brief Records the time since `t` was last started or lapped as a sample in `s`, then starts `t` again from now.
+ * @param t
+ * @param s
+ * @return The time of the lap in nanoseconds.
+ */
+uint64_t parlTimer_lap(ParlTimer* t, ParlTimerStats* s);
+
+uint64_t parlTimer_ns(const ParlTimer* t);
+
+/**
+ * @return The number of cycles between starting and stopping `t`. See `parlTimer_cycleCount`.
+ */
+uint64_t parlTimer_cycles(const ParlTimer* t);
+
 double parlTimer_secs(const ParlTimer* t);
 
 double parlTimer_ms(const ParlTimer* t);
 
-int parlTimer_microSecs(const ParlTimer* t);
+int64_t parlTimer_microSecs(const ParlTimer* t);
+
+/**
+ * @brief Allocates room for samples in `s`.
+ * @param s
+ * @param capacity The most samples to keep. Samples beyond this still count towards the mean, and each one replaces a
+ * random kept sample with the chance that keeps every sample equally likely to be kept.
+ * @return Whether the initialization was successful.
+ */
+bool parlTimerStats_init(ParlTimerStats* s, int capacity);
+
+/**
+ * @brief Frees the memory allocated for `s`, not including the `ParlTimerStats` struct itself.
+ * @param s
+ */
+void parlTimerStats_free(ParlTimerStats* s);
+
+/**
+ * @brief Removes every sample from `s`.
+ * @param s
+ */
+void parlTimerStats_clear(ParlTimerStats* s);
+
+/**
+ * @brief Adds a sample to `s`.
+ * @param s
+ * @param ns The sample in nanoseconds. This doesn't have to be a whole number, for example if it's the time of one call
+ * out of many that were timed together.
+ */
+void parlTimerStats_add(ParlTimerStats* s, double ns);
+
+/**
+ * @brief Summarizes the samples in `s`.
+ * @note This sorts `s->samples`.
+ * @param s
+ * @param out Where to write the summary. If there are no samples, everything but `count` is 0.
+ */
+void parlTimerStats_summarize(ParlTimerStats* s, ParlTimerSummary* out);
 
 #endif //PARLIAMENT_TIMER_H
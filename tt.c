@@ -0,0 +1,139 @@
+#include "tt.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define PARL_TT_STORED_BIT (1ull << 26)
+#define PARL_TT_DEPTH_SHIFT 32
+#define PARL_TT_BOUND_SHIFT 48
+#define PARL_TT_AGE_SHIFT 56
+
+#define PARL_TT_LOAD(x) atomic_load_explicit(&(x), memory_order_relaxed)
+#define PARL_TT_STORE(x, v) atomic_store_explicit(&(x), (v), memory_order_relaxed)
+
+static uint64_t parlTT_packStats(const ParlTTData* const d)
+{
+    uint32_t valueBits;
+    memcpy(&valueBits, &d->value, sizeof valueBits);
+    return (uint64_t)d->visits << 32 | valueBits;
+}
+
+static uint64_t parlTT_packInfo(const ParlTTData* const d, const uint8_t age)
+{
+    return (uint64_t)d->bestMove.action
+        | (uint64_t)d->bestMove.idxA << 8
+        | (uint64_t)d->bestMove.idxB << 14
+        | (uint64_t)d->bestMove.idxC << 20
+        | PARL_TT_STORED_BIT
+        | (uint64_t)d->depth << PARL_TT_DEPTH_SHIFT
+        | (uint64_t)d->bound << PARL_TT_BOUND_SHIFT
+        | (uint64_t)age << PARL_TT_AGE_SHIFT;
+}
+
+static void parlTT_unpack(const uint64_t stats, const uint64_t info, ParlTTData* const out)
+{
+    const uint32_t valueBits = (uint32_t)stats;
+    memcpy(&out->value, &valueBits, sizeof valueBits);
+    out->visits = stats >> 32;
+
+    out->bestMove = (ParlMove){
+        .action = info & 0xFF,
+        .idxA = info >> 8 & 0x3F,
+        .idxB = info >> 14 & 0x3F,
+        .idxC = info >> 20 & 0x3F
+    };
+    out->depth = info >> PARL_TT_DEPTH_SHIFT;
+    out->bound = info >> PARL_TT_BOUND_SHIFT & 0x3;
+}
+
+bool parlTT_init(ParlTT* const tt, const size_t bytes)
+{
+    register size_t numBuckets = 1;
+
+    while(numBuckets * 2 * sizeof(ParlTTBucket) <= bytes)
+        numBuckets *= 2;
+
+    *tt = (ParlTT){
+        .buckets = calloc(numBuckets, sizeof(ParlTTBucket)),
+        .mask = numBuckets - 1,
+        .age = 0
+    };
+
+    return tt->buckets;
+}
+
+void parlTT_free(ParlTT* const tt)
+{
+    free(tt->buckets);
+    tt->buckets = NULL;
+}
+
+void parlTT_clear(ParlTT* const tt)
+{
+    memset(tt->buckets, 0, (tt->mask + 1) * sizeof(ParlTTBucket));
+    tt->age = 0;
+}
+
+void parlTT_newSearch(ParlTT* const tt)
+{
+    ++tt->age;
+}
+
+bool parlTT_probe(const ParlTT* const tt, const uint64_t hash, ParlTTData* const out)
+{
+    ParlTTBucket* const b = &tt->buckets[hash & tt->mask];
+
+    for(register int i = 0; i < PARL_TT_BUCKET_SIZE; ++i)
+    {
+        const uint64_t check = PARL_TT_LOAD(b->entries[i].check),
+            stats = PARL_TT_LOAD(b->entries[i].stats),
+            info = PARL_TT_LOAD(b->entries[i].info);
+
+        if((info & PARL_TT_STORED_BIT) && (check ^ stats ^ info) == hash)
+        {
+            parlTT_unpack(stats, info, out);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void parlTT_store(ParlTT* const tt, const uint64_t hash, const ParlTTData* const d)
+{
+    ParlTTBucket* const b = &tt->buckets[hash & tt->mask];
+    register ParlTTEntry* victim = NULL;
+    register int victimScore = 0;
+
+    for(register int i = 0; i < PARL_TT_BUCKET_SIZE; ++i)
+    {
+        ParlTTEntry* const e = &b->entries[i];
+        const uint64_t check = PARL_TT_LOAD(e->check),
+            stats = PARL_TT_LOAD(e->stats),
+            info = PARL_TT_LOAD(e->info);
+
+        // Empty entries and older versions of this state are always replaced
+        if(!(info & PARL_TT_STORED_BIT) || (check ^ stats ^ info) == hash)
+        {
+            victim = e;
+            break;
+        }
+
+        // Otherwise, replace the entry that is shallowest after accounting for how many searches ago it was stored
+        const register uint8_t age = tt->age - (uint8_t)(info >> PARL_TT_AGE_SHIFT);
+        const register int score = (int)(uint16_t)(info >> PARL_TT_DEPTH_SHIFT) - PARL_TT_AGE_WEIGHT * age;
+
+        if(!victim || score < victimScore)
+        {
+            victim = e;
+            victimScore = score;
+        }
+    }
+
+    const uint64_t stats = parlTT_packStats(d),
+        info = parlTT_packInfo(d, tt->age);
+
+    PARL_TT_STORE(victim->stats, stats);
+    PARL_TT_STORE(victim->info, info);
+    PARL_TT_STORE(victim->check, hash ^ stats ^ info);
+}
@@ -0,0 +1,156 @@
+/**
+ * @file
+ * @brief A fixed-size transposition table for searches over `ParlGame` states, keyed by `ParlGame.hash`.
+ *
+ * @details
+ * The table is an array of buckets, each holding `PARL_TT_BUCKET_SIZE` entries. A state can only be stored in the bucket
+ * picked by the low bits of its hash. When the bucket is full, the entry that is shallowest and oldest is replaced.
+ *
+ * The table is safe to share between threads without locks. Each entry is stored as words that are read and written
+ * individually, with the first word being the hash XOR-ed with all the others. A reader that sees a half-written entry
+ * will almost certainly find that the words don't XOR back to the hash it's probing for, and treat it as a miss.
+ */
+
+#ifndef PARLIAMENT_TT_H
+#define PARLIAMENT_TT_H
+
+#include "game.h"
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+/**
+ * The number of entries in each bucket.
+ */
+#define PARL_TT_BUCKET_SIZE 4
+
+/**
+ * How much one generation of age counts against an entry compared to one ply of depth when choosing which entry in a
+ * bucket to replace.
+ */
+#define PARL_TT_AGE_WEIGHT 4
+
+/**
+ * What a stored value means relative to the true value of the state, for searches that cut off.
+ */
+typedef enum ParlTTBound
+{
+    PARL_TT_EXACT,
+    PARL_TT_LOWER,
+    PARL_TT_UPPER
+} ParlTTBound;
+
+/**
+ * @brief Everything stored about a state.
+ */
+typedef struct ParlTTData
+{
+    /**
+     * The value of the state, from whatever perspective the search uses.
+     */
+    float value;
+
+    /**
+     * How many times the state was visited, for searches that count visits.
+     */
+    uint32_t visits;
+
+    /**
+     * The best move found from the state.
+     */
+    ParlMove bestMove;
+
+    /**
+     * How deep the state was searched.
+     */
+    uint16_t depth;
+
+    ParlTTBound bound;
+} ParlTTData;
+
+/**
+ * @brief A packed `ParlTTData` and the hash it belongs to.
+ */
+typedef struct ParlTTEntry
+{
+    /**
+     * The hash, XOR-ed with `stats` and `info`.
+     */
+    _Atomic uint64_t check;
+
+    /**
+     * `value` in the low 32 bits and `visits` in the high 32 bits.
+     */
+    _Atomic uint64_t stats;
+
+    /**
+     * The best move, depth, bound, and age of the entry. Nonzero for any entry that has been stored.
+     */
+    _Atomic uint64_t info;
+} ParlTTEntry;
+
+typedef struct ParlTTBucket
+{
+    ParlTTEntry entries[PARL_TT_BUCKET_SIZE];
+} ParlTTBucket;
+
+typedef struct ParlTT
+{
+    ParlTTBucket* buckets;
+
+    /**
+     * The number of buckets minus 1. The number of buckets is always a power of 2.
+     */
+    uint64_t mask;
+
+    /**
+     * Incremented at the start of every search so that entries from older searches are replaced first.
+     */
+    uint8_t age;
+} ParlTT;
+
+/**
+ * @brief Allocates an empty table.
+ * @param tt
+ * @param bytes The most memory the table may use. This is rounded down to a power of 2 number of buckets, but there is
+ * always at least one.
+ * @return Whether the allocation was successful.
+ */
+bool parlTT_init(ParlTT* tt, size_t bytes);
+
+/**
+ * @brief Frees the memory allocated for `tt`, not including the `ParlTT` struct itself.
+ * @param tt
+ */
+void parlTT_free(ParlTT* tt);
+
+/**
+ * @brief Removes every entry from `tt`.
+ * @param tt
+ */
+void parlTT_clear(ParlTT* tt);
+
+/**
+ * @brief Marks every entry currently in `tt` as being from an older search.
+ * @param tt
+ */
+void parlTT_newSearch(ParlTT* tt);
+
+/**
+ * @brief Looks up a state.
+ * @param tt
+ * @param hash The `ParlGame.hash` of the state.
+ * @param out Where to write what's stored about the state, if it's found.
+ * @return Whether the state was found.
+ */
+bool parlTT_probe(const ParlTT* tt, uint64_t hash, ParlTTData* out);
+
+/**
+ * @brief Stores a state, replacing what was stored about it before if anything.
+ * @param tt
+ * @param hash The `ParlGame.hash` of the state.
+ * @param d
+ */
+void parlTT_store(ParlTT* tt, uint64_t hash, const ParlTTData* d);
+
+#endif //PARLIAMENT_TT_H
@@ -0,0 +1,384 @@
+/**
+ * @file
+ * @brief A long-lived engine that another process drives one line at a time over stdin and stdout, like UCI in chess.
+ *
+ * @details
+ * Usage: `parliament_uci [numThreads] [capacity]`
+ *
+ * Commands:
+ * - `init numJokers numPlayers myPosition card` starts a new game from the known player's point of view, like
+ *   `parlGame_init`.
+ * - `ACTION [card [card [card]]]` makes a move, where `ACTION` is a `ParlAction` by name, such as `APPOINT_MP 3h`, and
+ *   each card is a symbol for `parlSymbolToIdx`, or `-` for no card.
+ * - `go [movetime ms] [iterations n] [infinite]` searches the current position in the background and then prints
+ *   `bestmove` followed by a move in the same form. With neither `movetime` nor `iterations`, it searches for one
+ *   second, and with `infinite`, until `stop`. When the known player is told to `DRAW`, they should report the card
+ *   they drew with `SELF_DRAW`.
+ * - `stop` ends the search early.
+ * - `isready` prints `readyok`, even while searching.
+ * - `quit` exits.
+ *
+ * Anything that can't be done prints `error` and a reason. Commands other than `stop`, `isready` and `quit` wait for
+ * the search to finish first.
+ *
+ * The threads and node pool are only set up once. The search tree is kept between searches and follows the moves
+ * that are made, so a search after a move picks up where the last one left off. The moves are also tracked in a
+ * `ParlBelief`, which the search deals its determinizations by.
+ *
+ * Once the draw deck runs out, `go` solves the endgame with `parlEndgame_solveSampled` instead of searching, and prints
+ * `info endgame value` with the average solved value of the best move before `bestmove`.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "endgame.h"
+#include "search.h"
+
+#define PARL_UCI_NUM_ACTIONS (ENDGAME_NO_COUNTER_BLOCK_COALITION + 1)
+
+/**
+ * The longest line that is read as one command.
+ */
+#define PARL_UCI_MAX_LINE 256
+
+#define PARL_UCI_DELIMITERS " \t\r\n"
+
+/**
+ * How many deals of the hidden hands an endgame is solved for.
+ */
+#define PARL_UCI_ENDGAME_WORLDS 256
+
+/**
+ * The memory for the endgame solver's table of solved positions.
+ */
+#define PARL_UCI_ENDGAME_TT_BYTES (16u << 20)
+
+static const char* const PARL_UCI_ACTION_NAMES[PARL_UCI_NUM_ACTIONS] = {
+    "DRAW",
+    "SELF_DRAW",
+    "DISCARD",
+    "APPOINT_MP",
+    "CALL_ELECTION",
+    "IMPEACH_MP",
+    "IMPEACH_PM",
+    "VOTE_NO_CONF",
+    "CABINET_RESHUFFLE",
+    "APPOINT_PM",
+    "REIMPEACH",
+    "BLOCK_IMPEACH",
+    "NO_REIMPEACH",
+    "NO_BLOCK_IMPEACH",
+    "CONTEST_ELECTION",
+    "NO_CONTEST_ELECTION",
+    "APPOINT_BACKUP_PM",
+    "ENDGAME_PM_FIRST",
+    "ENDGAME_PM_LAST",
+    "ENDGAME_TRY_FORMATION",
+    "ENDGAME_PASS_FORMATION",
+    "ENDGAME_BLOCK_COALITION",
+    "ENDGAME_COUNTER_BLOCK_COALITION",
+    "ENDGAME_NO_BLOCK_COALITION",
+    "ENDGAME_NO_COUNTER_BLOCK_COALITION"
+};
+
+typedef struct ParlUci
+{
+    ParlGame g;
+    bool hasGame;
+
+    /**
+     * What the moves so far say about the hidden hands in `g`, which the search deals determinizations by.
+     */
+    ParlBelief belief;
+
+    ParlSearch search;
+    ParlSearchConfig cfg;
+
+    ParlEndgameSolver endgame;
+
+    /**
+     * Deals the hidden hands for `endgame`.
+     */
+    ParlRng rng;
+
+    /**
+     * Set by `stop` to end the search, through `cfg.stop`.
+     */
+    atomic_bool stop;
+
+    /**
+     * The thread running the search, if `searching`.
+     */
+    pthread_t thread;
+    bool searching;
+} ParlUci;
+
+/**
+ * @brief Reads the card with the symbol `token`, or `PARL_NO_ARG` for `-`.
+ * @return Whether `token` was either.
+ */
+static bool parlUci_parseCard(const char* const token, ParlIdx* const out)
+{
+    if(strcmp(token, "-") == 0)
+    {
+        *out = PARL_NO_ARG;
+        return true;
+    }
+
+    if(strlen(token) != PARL_SYMBOL_WIDTH)
+        return false;
+
+    *out = parlSymbolToIdx(token);
+    return *out <= PARL_JOKER_IDX;
+}
+
+/**
+ * @brief Prints `m` in the form that it's read in, after `prefix` and a space.
+ */
+static void parlUci_printMove(const char* const prefix, const ParlMove m)
+{
+    const ParlIdx args[3] = {m.idxA, m.idxB, m.idxC};
+    ParlCardSymbol symbol;
+    register int numArgs = 3;
+
+    while(numArgs && PARL_IS_NO_ARG(args[numArgs - 1]))
+        --numArgs;
+
+    printf("%s %s", prefix, PARL_UCI_ACTION_NAMES[m.action]);
+
+    for(register int i = 0; i < numArgs; ++i)
+        if(PARL_IS_NO_ARG(args[i]))
+            printf(" -");
+        else
+        {
+            parlCardSymbol(symbol, args[i]);
+            printf(" %.*s", PARL_SYMBOL_WIDTH, symbol);
+        }
+
+    putchar('\n');
+    fflush(stdout);
+}
+
+static void* parlUci_searchMain(void* const arg)
+{
+    ParlUci* const u = arg;
+    ParlMove best;
+    float value;
+
+    if(PARL_ENDGAME_PHASE(&u->g)
+        && parlEndgame_solveSampled(&u->endgame, &u->g, PARL_UCI_ENDGAME_WORLDS, &u->rng, &best, &value))
+    {
+        printf("info endgame value %.3f nodes %lu\n", value, u->endgame.nodes);
+        parlUci_printMove("bestmove", best);
+    }
+    else if(parlSearch_run(&u->search, &u->g, &u->cfg, &best))
+    {
+        printf("info iterations %ld\n", (long)u->search.iterations);
+        parlUci_printMove("bestmove", best);
+    }
+    else
+    {
+        puts("bestmove none");
+        fflush(stdout);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Waits for the search to finish, if one is running.
+ */
+static void parlUci_wait(ParlUci* const u)
+{
+    if(u->searching)
+    {
+        pthread_join(u->thread, NULL);
+        u->searching = false;
+    }
+}
+
+static void parlUci_error(const char* const reason)
+{
+    printf("error %s\n", reason);
+    fflush(stdout);
+}
+
+static void parlUci_init(ParlUci* const u)
+{
+    const char* tokens[4];
+
+    for(register int i = 0; i < 4; ++i)
+        if(!(tokens[i] = strtok(NULL, PARL_UCI_DELIMITERS)))
+        {
+            parlUci_error("usage: init numJokers numPlayers myPosition card");
+            return;
+        }
+
+    const int numJokers = atoi(tokens[0]), numPlayers = atoi(tokens[1]);
+    const ParlPlayer myPosition = atoi(tokens[2]);
+    ParlIdx card;
+
+    if(numPlayers < 2 || numPlayers > PARL_MAX_NUM_PLAYERS || myPosition < 0 || myPosition >= numPlayers
+        || !parlUci_parseCard(tokens[3], &card) || card > PARL_JOKER_IDX || (card == PARL_JOKER_IDX && !numJokers)
+        || !parlGame_init(&u->g, numJokers, numPlayers, myPosition, card))
+    {
+        parlUci_error("invalid game");
+        return;
+    }
+
+    parlBelief_init(&u->belief);
+    u->hasGame = true;
+}
+
+static void parlUci_move(ParlUci* const u, const char* const name)
+{
+    register int action = 0;
+    ParlIdx args[3] = {PARL_NO_ARG, PARL_NO_ARG, PARL_NO_ARG};
+    const char* token;
+
+    while(action < PARL_UCI_NUM_ACTIONS && strcmp(name, PARL_UCI_ACTION_NAMES[action]) != 0)
+        ++action;
+
+    if(action == PARL_UCI_NUM_ACTIONS)
+    {
+        parlUci_error("unknown command");
+        return;
+    }
+
+    for(register int i = 0; (token = strtok(NULL, PARL_UCI_DELIMITERS)); ++i)
+        if(i >= 3 || !parlUci_parseCard(token, &args[i]))
+        {
+            parlUci_error("invalid card");
+            return;
+        }
+
+    if(!u->hasGame)
+    {
+        parlUci_error("no game");
+        return;
+    }
+
+    const ParlMove m = {.action = action, .idxA = args[0], .idxB = args[1], .idxC = args[2]};
+    const ParlGame before = u->g;
+
+    if(!(parlGame_legalActions(&u->g) & 1u << action) || !parlGame_applyMove(&u->g, m))
+    {
+        // An illegal move may have changed part of the game before it was found to be illegal
+        u->g = before;
+        parlUci_error("illegal move");
+        return;
+    }
+
+    parlBelief_update(&u->belief, &before, m, &u->g);
+    parlSearch_advance(&u->search, m, &u->g);
+}
+
+static void parlUci_go(ParlUci* const u)
+{
+    const char* token;
+
+    if(!u->hasGame)
+    {
+        parlUci_error("no game");
+        return;
+    }
+
+    u->cfg.maxMs = 0;
+    u->cfg.maxIterations = 0;
+    bool infinite = false;
+
+    while((token = strtok(NULL, PARL_UCI_DELIMITERS)))
+    {
+        if(strcmp(token, "infinite") == 0)
+            infinite = true;
+        else if(strcmp(token, "movetime") == 0 && (token = strtok(NULL, PARL_UCI_DELIMITERS)))
+            u->cfg.maxMs = atof(token);
+        else if(strcmp(token, "iterations") == 0 && (token = strtok(NULL, PARL_UCI_DELIMITERS)))
+            u->cfg.maxIterations = atol(token);
+    }
+
+    if(!infinite && u->cfg.maxMs <= 0 && u->cfg.maxIterations <= 0)
+        u->cfg.maxMs = PARL_SEARCH_DEFAULT_CONFIG.maxMs;
+
+    ++u->cfg.seed;
+    atomic_store(&u->stop, false);
+
+    if(pthread_create(&u->thread, NULL, parlUci_searchMain, u))
+    {
+        parlUci_error("could not start search");
+        return;
+    }
+
+    u->searching = true;
+}
+
+int main(const int argc, const char* const argv[])
+{
+    const int numThreads = argc > 1 ? atoi(argv[1]) : 1;
+    const long capacity = argc > 2 ? atol(argv[2]) : 1 << 22;
+    static ParlUci u;
+    char line[PARL_UCI_MAX_LINE];
+
+    if(numThreads < 1 || capacity < 2 * numThreads || !parlSearch_init(&u.search, capacity, numThreads))
+    {
+        fprintf(stderr, "usage: %s [numThreads] [capacity]\n", argv[0]);
+        return 1;
+    }
+
+    if(!parlEndgame_init(&u.endgame, PARL_UCI_ENDGAME_TT_BYTES))
+    {
+        parlSearch_free(&u.search);
+        fputs("could not allocate the endgame table\n", stderr);
+        return 1;
+    }
+
+    u.cfg = PARL_SEARCH_DEFAULT_CONFIG;
+    u.cfg.reuseTree = true;
+    u.cfg.stop = &u.stop;
+    u.cfg.belief = &u.belief;
+    parlRng_seed(&u.rng, u.cfg.seed);
+
+    while(fgets(line, sizeof line, stdin))
+    {
+        const char* const command = strtok(line, PARL_UCI_DELIMITERS);
+
+        if(!command)
+            continue;
+
+        if(strcmp(command, "quit") == 0)
+            break;
+
+        // The only other command that doesn't wait for the search
+        if(strcmp(command, "stop") == 0)
+        {
+            atomic_store(&u.stop, true);
+            parlUci_wait(&u);
+            continue;
+        }
+
+        if(strcmp(command, "isready") == 0)
+        {
+            puts("readyok");
+            fflush(stdout);
+            continue;
+        }
+
+        parlUci_wait(&u);
+
+        if(strcmp(command, "init") == 0)
+            parlUci_init(&u);
+        else if(strcmp(command, "go") == 0)
+            parlUci_go(&u);
+        else
+            parlUci_move(&u, command);
+    }
+
+    atomic_store(&u.stop, true);
+    parlUci_wait(&u);
+    parlEndgame_free(&u.endgame);
+    parlSearch_free(&u.search);
+    return 0;
+}
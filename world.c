@@ -0,0 +1,154 @@
+#include "world.h"
+
+/**
+ * @brief Removes a uniformly random card from `pool`.
+ * @param pool Must not be empty.
+ * @param r
+ * @return The card that was removed.
+ */
+static inline ParlIdx parlWorld_take(ParlStack* const pool, ParlRng* const r)
+{
+    const register unsigned int numNonJokers = PARL_POPCOUNT(PARL_WITHOUT_JOKERS(*pool)),
+        n = parlRng_below(r, numNonJokers + PARL_NUM_JOKERS(*pool));
+
+    // Jokers are indistinguishable, so they share the ranks after all the non-joker cards
+    if(n >= numNonJokers)
+    {
+        const register ParlIdx joker = PARL_ANY_JOKER_IDX(*pool);
+        *pool -= PARL_CARD(joker);
+        return joker;
+    }
+
+    const register ParlIdx i = PARL_NTH_IDX(*pool, n);
+    *pool &= ~PARL_CARD(i);
+    return i;
+}
+
+/**
+ * @brief Removes a random card from `pool`, where each card is as likely as its weight in `weights`.
+ * @param pool Must not be empty.
+ * @param weights One player's row of `ParlBelief.weights`.
+ * @param r
+ * @return The card that was removed.
+ */
+static ParlIdx parlWorld_takeWeighted(ParlStack* const pool, const uint16_t* const weights, ParlRng* const r)
+{
+    const register ParlStack nonJokers = PARL_WITHOUT_JOKERS(*pool);
+    const register uint32_t jokersWeight = PARL_NUM_JOKERS(*pool) * weights[PARL_JOKER_IDX];
+    register uint32_t total = jokersWeight;
+
+    PARL_FOREACH_IN_STACK(nonJokers, i)
+        total += weights[i];
+
+    register uint32_t n = parlRng_below(r, total);
+
+    PARL_FOREACH_IN_STACK(nonJokers, i)
+    {
+        if(n < weights[i])
+        {
+            *pool &= ~PARL_CARD(i);
+            return i;
+        }
+
+        n -= weights[i];
+    }
+
+    const register ParlIdx joker = PARL_ANY_JOKER_IDX(*pool);
+    *pool -= PARL_CARD(joker);
+    return joker;
+}
+
+/**
+ * @brief Gives everyone in `w` the cards they're known to have, and takes those cards out of `pool`.
+ * @param w
+ * @param g
+ * @param pool Starts as the face-down cards, and is left as the cards that are still to be dealt.
+ * @param numHidden Where to write the number of cards each player still needs.
+ * @return Whether `pool` has as many cards as the hands and draw deck need.
+ */
+static bool parlWorld_dealKnown(ParlWorld* const w,
+                                const ParlGame* const g,
+                                ParlStack* const pool,
+                                int* const numHidden)
+{
+    register int totalHidden = 0;
+
+    PARL_FOREACH_PLAYER(g, p)
+    {
+        register ParlStack known = g->knownHands[p];
+        register int handSize = g->handSizes[p];
+
+        if(g->mode == ELECTION_MODE && g->elecCands[p].callingCards != PARL_EMPTY_STACK)
+        {
+            // Calling cards that didn't come from the Cabinet or the PM card are still in the candidate's hand
+            register ParlStack fromHand = g->elecCands[p].callingCards & ~g->cabinet;
+
+            if(g->pmPosition != PARL_NO_PM)
+                fromHand &= ~PARL_CARD(g->pmCardIdx);
+
+            known |= fromHand;
+            handSize = g->elecCands[p].preCallNumCards;
+        }
+
+        numHidden[p] = handSize - PARL_STACK_SIZE(known);
+        if(numHidden[p] < 0)
+            return false;
+
+        totalHidden += numHidden[p];
+        w->hands[p] = known;
+
+        // Known jokers have already left `faceDownCards`, but known non-joker calling cards may not have
+        *pool &= ~PARL_WITHOUT_JOKERS(known);
+    }
+
+    return PARL_STACK_SIZE(*pool) == totalHidden + (int)g->drawDeckSize;
+}
+
+bool parlWorld_sample(ParlWorld* const w, const ParlGame* const g, ParlRng* const r)
+{
+    ParlStack pool = g->faceDownCards;
+    int numHidden[PARL_MAX_NUM_PLAYERS];
+
+    /* Step 1: Give everyone the cards they're known to have */
+
+    if(!parlWorld_dealKnown(w, g, &pool, numHidden))
+        return false;
+
+    /* Step 2: Deal the rest of everyone's hands */
+
+    PARL_FOREACH_PLAYER(g, p)
+        for(register int i = numHidden[p]; i > 0; --i)
+            w->hands[p] += PARL_CARD(parlWorld_take(&pool, r));
+
+    /* Step 3: Whatever is left is the draw deck, in random order */
+
+    w->drawDeckSize = g->drawDeckSize;
+    parlWorld_shuffleDeck(w->drawDeck, pool, r);
+
+    return true;
+}
+
+bool parlWorld_sampleBelief(ParlWorld* const w, const ParlGame* const g, const ParlBelief* const b, ParlRng* const r)
+{
+    ParlStack pool = g->faceDownCards;
+    int numHidden[PARL_MAX_NUM_PLAYERS];
+
+    if(!parlWorld_dealKnown(w, g, &pool, numHidden))
+        return false;
+
+    PARL_FOREACH_PLAYER(g, p)
+        for(register int i = numHidden[p]; i > 0; --i)
+            w->hands[p] += PARL_CARD(parlWorld_takeWeighted(&pool, b->weights[p], r));
+
+    w->drawDeckSize = g->drawDeckSize;
+    parlWorld_shuffleDeck(w->drawDeck, pool, r);
+
+    return true;
+}
+
+void parlWorld_shuffleDeck(uint8_t* const deck, ParlStack cards, ParlRng* const r)
+{
+    // Taking cards out in random order is a Fisher-Yates shuffle that never has to list the cards first
+    for(register int i = 0; cards; ++i)
+        deck[i] = parlWorld_take(&cards, r);
+}
@@ -0,0 +1,87 @@
+/**
+ * @file
+ * @brief Determinization: dealing the cards the known player can't see so that a `ParlGame` becomes a single
+ * full-information world.
+ *
+ * @details
+ * In a `ParlGame`, `faceDownCards` lumps together the draw deck and every card in other players' hands that the known
+ * player hasn't seen. A `ParlWorld` is one way those cards could actually be laid out. Each player holds everything
+ * they're known to hold plus enough face-down cards to make up their hand size, and the rest form the draw deck in some
+ * order. Every such layout is equally likely to be sampled, unless the cards are dealt by the weights of a `ParlBelief`
+ * with `parlWorld_sampleBelief`.
+ *
+ * Sampling works directly on the bitboards. Each card is picked by choosing a random rank among the cards left and
+ * selecting that set bit with `PARL_NTH_IDX`, so a whole world costs one random number and a couple of bit operations
+ * per face-down card.
+ */
+
+#ifndef PARLIAMENT_WORLD_H
+#define PARLIAMENT_WORLD_H
+
+#include "belief.h"
+#include "game.h"
+#include "rng.h"
+
+/**
+ * The most cards the draw deck can hold, which is bounded by the width of `ParlGame.drawDeckSize`.
+ */
+#define PARL_MAX_DRAW_DECK_SIZE 64
+
+/**
+ * @brief A full-information layout of the cards in a `ParlGame`.
+ */
+typedef struct ParlWorld
+{
+    /**
+     * Every player's whole hand.
+     */
+    ParlStack hands[PARL_MAX_NUM_PLAYERS];
+
+    /**
+     * The draw deck from the bottom up, so the next card to be drawn is `drawDeck[drawDeckSize - 1]`. Jokers are
+     * `PARL_JOKER_IDX`, or their own indices with distinct jokers.
+     */
+    uint8_t drawDeck[PARL_MAX_DRAW_DECK_SIZE];
+
+    int drawDeckSize;
+} ParlWorld;
+
+/**
+ * @brief Deals the face-down cards in `g` at random into a world that's consistent with everything the known player
+ * knows.
+ *
+ * @details
+ * Each player gets `knownHands[p]` plus random face-down cards up to `handSizes[p]`. During an election, a candidate's
+ * hand also includes the calling cards they played from their hand, since those don't leave it until the election is
+ * resolved.
+ *
+ * @param w Where to write the world.
+ * @param g
+ * @param r
+ * @return Whether the face-down cards could be dealt, which is false only if `g` has fewer or more face-down cards
+ * than the hands and draw deck need.
+ */
+bool parlWorld_sample(ParlWorld* w, const ParlGame* g, ParlRng* r);
+
+/**
+ * @brief Same as `parlWorld_sample`, but each face-down card is dealt to a player as often as their weight for it in
+ * `b` makes it likely, rather than uniformly. The draw deck is still shuffled uniformly.
+ * @note Dealing a card takes time proportional to the number of face-down cards, rather than constant time.
+ * @param w
+ * @param g
+ * @param b
+ * @param r
+ * @return Whether the face-down cards could be dealt, like `parlWorld_sample`.
+ */
+bool parlWorld_sampleBelief(ParlWorld* w, const ParlGame* g, const ParlBelief* b, ParlRng* r);
+
+/**
+ * @brief Puts the cards in `cards` into `deck` in a uniformly random order.
+ * @param deck Where to write the cards, one `ParlIdx` per card, with jokers as in `PARL_ANY_JOKER_IDX`. This must have
+ * room for `PARL_STACK_SIZE(cards)` cards.
+ * @param cards
+ * @param r
+ */
+void parlWorld_shuffleDeck(uint8_t* deck, ParlStack cards, ParlRng* r);
+
+#endif //PARLIAMENT_WORLD_H
@@ -0,0 +1,35 @@
+#include "zobrist.h"
+
+/**
+ * @return The XOR of the keys of every card in `s`.
+ */
+static uint64_t parlZobrist_stack(const unsigned int field, const ParlPlayer p, const ParlStack s)
+{
+    register uint64_t h = parlZobrist_jokerKey(field, p, s);
+
+    PARL_FOREACH_IN_STACK(s, i)
+        h ^= parlZobrist_key(field, p, i);
+
+    return h;
+}
+
+uint64_t parlZobrist_hash(const ParlGame* const g)
+{
+    register uint64_t h = 0;
+
+#define PARL_ZOBRIST_HASH_SCALAR(field, member) h ^= parlZobrist_key(field, 0, g->member);
+#define PARL_ZOBRIST_HASH_STACK(field, member) h ^= parlZobrist_stack(field, 0, g->member);
+#define PARL_ZOBRIST_HASH_PLAYER_SCALAR(field, member) h ^= parlZobrist_key(field, p, g->member);
+#define PARL_ZOBRIST_HASH_PLAYER_STACK(field, member) h ^= parlZobrist_stack(field, p, g->member);
+
+    PARL_ZOBRIST_FOREACH_SCALAR(PARL_ZOBRIST_HASH_SCALAR)
+    PARL_ZOBRIST_FOREACH_STACK(PARL_ZOBRIST_HASH_STACK)
+
+    PARL_FOREACH_PLAYER(g, p)
+    {
+        PARL_ZOBRIST_FOREACH_PLAYER_SCALAR(PARL_ZOBRIST_HASH_PLAYER_SCALAR)
+        PARL_ZOBRIST_FOREACH_PLAYER_STACK(PARL_ZOBRIST_HASH_PLAYER_STACK)
+    }
+
+    return h;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file
+ * @brief Zobrist hashing of `ParlGame` states.
+ *
+ * @details
+ * Every piece of state in a `ParlGame` that can change during a game gets a random 64-bit key, and a game's hash is the
+ * XOR of the keys of everything it holds. For a stack, that is one key per non-joker card plus one key for the number
+ * of jokers. For a scalar field, it's one key per value. Because XOR is its own inverse, the hash can be updated by
+ * XOR-ing in the keys of only the things that changed. game.c does this at every place it changes a field, using the
+ * keys below, so `ParlGame.hash` is kept up to date without ever looking at the rest of the game.
+ *
+ * The keys are never stored anywhere. Each one is computed when it's needed by mixing the field, player, and value
+ * together, so there's nothing to initialize and every program gets the same hashes.
+ */
+
+#ifndef PARLIAMENT_ZOBRIST_H
+#define PARLIAMENT_ZOBRIST_H
+
+#include "game.h"
+
+/**
+ * The fields that get their own set of keys. Per-player fields are told apart by the player passed with them.
+ */
+enum ParlZobristField
+{
+    PARL_ZOBRIST_PARLIAMENT = 1,
+    PARL_ZOBRIST_CABINET,
+    PARL_ZOBRIST_DISCARD,
+    PARL_ZOBRIST_FACE_DOWN,
+    PARL_ZOBRIST_NUM_PLAYERS,
+    PARL_ZOBRIST_MY_POSITION,
+    PARL_ZOBRIST_ALL_HANDS_KNOWN,
+    PARL_ZOBRIST_TURN,
+    PARL_ZOBRIST_PM_POSITION,
+    PARL_ZOBRIST_PM_CARD,
+    PARL_ZOBRIST_DRAW_DECK_SIZE,
+    PARL_ZOBRIST_MODE,
+    PARL_ZOBRIST_COALITION_SIZE,
+    PARL_ZOBRIST_ENDGAME_SKIP_PM,
+    PARL_ZOBRIST_CURR_NORMAL_TURN,
+    PARL_ZOBRIST_CARD_TO_BEAT,
+    PARL_ZOBRIST_IMPEACHED_MP,
+    PARL_ZOBRIST_CYCLE_STARTER,
+    PARL_ZOBRIST_KNOWN_HAND,
+    PARL_ZOBRIST_HAND_SIZE,
+    PARL_ZOBRIST_CALLING_CARDS,
+    PARL_ZOBRIST_CAND_PM,
+    PARL_ZOBRIST_CAND_PRE_CALL_NUM_CARDS
+};
+
+/**
+ * Calls `X(field, member)` for every field of a `ParlGame` that isn't per-player.
+ */
+#define PARL_ZOBRIST_FOREACH_SCALAR(X)                          \
+    X(PARL_ZOBRIST_NUM_PLAYERS, numPlayers)                     \
+    X(PARL_ZOBRIST_MY_POSITION, myPosition)                     \
+    X(PARL_ZOBRIST_ALL_HANDS_KNOWN, allHandsKnown)              \
+    X(PARL_ZOBRIST_TURN, turn)                                  \
+    X(PARL_ZOBRIST_PM_POSITION, pmPosition)                     \
+    X(PARL_ZOBRIST_PM_CARD, pmCardIdx)                          \
+    X(PARL_ZOBRIST_DRAW_DECK_SIZE, drawDeckSize)                \
+    X(PARL_ZOBRIST_MODE, mode)                                  \
+    X(PARL_ZOBRIST_COALITION_SIZE, coalitionSize)               \
+    X(PARL_ZOBRIST_ENDGAME_SKIP_PM, endgameSkipPm)              \
+    X(PARL_ZOBRIST_CURR_NORMAL_TURN, currNormalTurn)            \
+    X(PARL_ZOBRIST_CARD_TO_BEAT, cardToBeatIdx)                 \
+    X(PARL_ZOBRIST_IMPEACHED_MP, impeachedMpIdx)                \
+    X(PARL_ZOBRIST_CYCLE_STARTER, cycleStarter)
+
+/**
+ * Calls `X(field, member)` for every stack in a `ParlGame` that isn't per-player.
+ */
+#define PARL_ZOBRIST_FOREACH_STACK(X)                           \
+    X(PARL_ZOBRIST_PARLIAMENT, parliament)                      \
+    X(PARL_ZOBRIST_CABINET, cabinet)                            \
+    X(PARL_ZOBRIST_DISCARD, discard)                            \
+    X(PARL_ZOBRIST_FACE_DOWN, faceDownCards)
+
+/**
+ * Calls `X(field, member)` for every per-player field of a `ParlGame`, where `p` is the player.
+ */
+#define PARL_ZOBRIST_FOREACH_PLAYER_SCALAR(X)                                   \
+    X(PARL_ZOBRIST_HAND_SIZE, handSizes[p])                                     \
+    X(PARL_ZOBRIST_CAND_PM, elecCands[p].pmIdx)                                 \
+    X(PARL_ZOBRIST_CAND_PRE_CALL_NUM_CARDS, elecCands[p].preCallNumCards)
+
+/**
+ * Calls `X(field, member)` for every per-player stack in a `ParlGame`, where `p` is the player.
+ */
+#define PARL_ZOBRIST_FOREACH_PLAYER_STACK(X)                                    \
+    X(PARL_ZOBRIST_KNOWN_HAND, knownHands[p])                                   \
+    X(PARL_ZOBRIST_CALLING_CARDS, elecCands[p].callingCards)
+
+/**
+ * The value under which the number of jokers in a stack is keyed. Any nonzero number of jokers is added to this.
+ */
+#define PARL_ZOBRIST_JOKER_VALUE 64
+
+/**
+ * @return The key for `field` of player `p` having the value `value`. Only the low 8 bits of `value` are used.
+ * @note This is the SplitMix64 finalizer, which is a bijection, so distinct inputs never share a key.
+ */
+static inline uint64_t parlZobrist_key(const unsigned int field, const ParlPlayer p, const unsigned int value)
+{
+    register uint64_t z = ((uint64_t)field << 16 | (uint64_t)(uint8_t)p << 8 | (uint8_t)value)
+        + 0x9E3779B97F4A7C15ull;
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @return The key for the number of jokers in `s`, or 0 if there are none.
+ */
+static inline uint64_t parlZobrist_jokerKey(const unsigned int field, const ParlPlayer p, const ParlStack s)
+{
+    return PARL_NUM_JOKERS(s) ? parlZobrist_key(field, p, PARL_ZOBRIST_JOKER_VALUE + PARL_NUM_JOKERS(s)) : 0;
+}
+
+/**
+ * @return The XOR of the keys of every card that is in exactly one of `before` and `after`.
+ */
+static inline uint64_t parlZobrist_stackDiff(const unsigned int field,
+                                             const ParlPlayer p,
+                                             const ParlStack before,
+                                             const ParlStack after)
+{
+    register uint64_t h = 0;
+
+    if(before == after)
+        return 0;
+
+    PARL_FOREACH_IN_STACK(before ^ after, i)
+        h ^= parlZobrist_key(field, p, i);
+
+    if(PARL_NUM_JOKERS(before) != PARL_NUM_JOKERS(after))
+        h ^= parlZobrist_jokerKey(field, p, before) ^ parlZobrist_jokerKey(field, p, after);
+
+    return h;
+}
+
+/**
+ * @brief Hashes every field of `g` from scratch.
+ * @param g
+ * @return The hash of `g`. This does not read `g->hash`, so it can be used to check the incrementally updated hash.
+ */
+uint64_t parlZobrist_hash(const ParlGame* g);
+
+#endif //PARLIAMENT_ZOBRIST_H